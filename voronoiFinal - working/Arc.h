@@ -15,13 +15,18 @@ struct Arc
     Arc* right;
     // Diagram
     VoronoiDiagram::Site* site;
-    VoronoiDiagram::HalfEdge* leftHalfEdge;
-    VoronoiDiagram::HalfEdge* rightHalfEdge;
+    // Copy of the site's point so that locateArcAbove does not have to reach the site
+    double focusX;
+    double focusY;
+    unsigned int leftHalfEdge;
+    unsigned int rightHalfEdge;
     Event* event;
     // Optimizations
     Arc* prev;
     Arc* next;
     // Only for balancing
     Color color;
+    // Slot in FlatBeachline or leaf in BTreeBeachline
+    unsigned int position;
 };
 
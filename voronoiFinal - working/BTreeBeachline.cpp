@@ -0,0 +1,388 @@
+#include "BTreeBeachline.h"
+#include "Arc.h"
+
+BTreeBeachline::BTreeBeachline(MemoryResource* resource) : BeachlineBase(resource),
+    mLeaves(resource), mInners(resource), mFreeLeaves(resource), mFreeInners(resource), mRoot(NONE), mHeight(0)
+{
+
+}
+
+void BTreeBeachline::clear()
+{
+    mLeaves.clear();
+    mInners.clear();
+    mFreeLeaves.clear();
+    mFreeInners.clear();
+    mRoot = NONE;
+    mHeight = 0;
+    clearArcs();
+}
+
+bool BTreeBeachline::isEmpty() const
+{
+    return mRoot == NONE;
+}
+
+void BTreeBeachline::setRoot(Arc* x)
+{
+    mRoot = createLeaf();
+    mHeight = 0;
+    insert(mRoot, 0, x);
+}
+
+Arc* BTreeBeachline::getLeftmostArc() const
+{
+    if (isEmpty())
+        return mNil;
+    unsigned int node = mRoot;
+    for (unsigned int height = mHeight; height > 0; --height)
+        node = mInners[node].children[0];
+    return mLeaves[node].arcs[0];
+}
+
+Arc* BTreeBeachline::locateArcAbove(const Vector2& point, double l)
+{
+    // Try the finger first
+    Arc* arc = walkFromFinger(point.x, l);
+    if (arc != nullptr)
+        return arc;
+    // Otherwise descend from the root, in each node look for the last child whose left breakpoint is not on the right of point
+    unsigned int node = mRoot;
+    for (unsigned int height = mHeight; height > 0; --height)
+    {
+        const Inner& inner = mInners[node];
+        unsigned int first = 0;
+        unsigned int last = inner.size - 1;
+        while (first < last)
+        {
+            unsigned int middle = (first + last + 1) / 2;
+            const Separator& separator = inner.separators[middle];
+            if (compareToBreakpoint(point.x, separator.leftX, separator.leftY, separator.rightX, separator.rightY, l) >= 0)
+                first = middle;
+            else
+                last = middle - 1;
+        }
+        node = inner.children[first];
+    }
+    // Then do the same with the arcs of the leaf
+    const Leaf& leaf = mLeaves[node];
+    unsigned int first = 0;
+    unsigned int last = leaf.size - 1;
+    while (first < last)
+    {
+        unsigned int middle = (first + last + 1) / 2;
+        if (compareToBreakpoint(point.x, leaf.focusX[middle - 1], leaf.focusY[middle - 1], leaf.focusX[middle], leaf.focusY[middle], l) >= 0)
+            first = middle;
+        else
+            last = middle - 1;
+    }
+    arc = leaf.arcs[first];
+    setFinger(arc);
+    return arc;
+}
+
+void BTreeBeachline::insertBefore(Arc* x, Arc* y)
+{
+    unsigned int leaf = x->position;
+    insert(leaf, getArcIndex(mLeaves[leaf], x), y);
+    // Set the pointers
+    y->prev = x->prev;
+    if (!isNil(y->prev))
+        y->prev->next = y;
+    y->next = x;
+    x->prev = y;
+    // Update the breakpoints that changed
+    updateSeparator(y);
+    updateSeparator(x);
+}
+
+void BTreeBeachline::insertAfter(Arc* x, Arc* y)
+{
+    unsigned int leaf = x->position;
+    insert(leaf, getArcIndex(mLeaves[leaf], x) + 1, y);
+    // Set the pointers
+    y->next = x->next;
+    if (!isNil(y->next))
+        y->next->prev = y;
+    y->prev = x;
+    x->next = y;
+    // Update the breakpoints that changed
+    updateSeparator(y);
+    updateSeparator(y->next);
+}
+
+void BTreeBeachline::replace(Arc* x, Arc* y)
+{
+    unsigned int leaf = x->position;
+    Leaf& node = mLeaves[leaf];
+    unsigned int i = getArcIndex(node, x);
+    node.arcs[i] = y;
+    node.focusX[i] = y->focusX;
+    node.focusY[i] = y->focusY;
+    y->position = leaf;
+    // Set the pointers
+    y->prev = x->prev;
+    y->next = x->next;
+    if (!isNil(y->prev))
+        y->prev->next = y;
+    if (!isNil(y->next))
+        y->next->prev = y;
+    // Update the breakpoints that changed
+    updateSeparator(y);
+    updateSeparator(y->next);
+    moveFinger(x, y);
+}
+
+void BTreeBeachline::remove(Arc* z)
+{
+    unsigned int leaf = z->position;
+    Leaf& node = mLeaves[leaf];
+    for (unsigned int i = getArcIndex(node, z) + 1; i < node.size; ++i)
+    {
+        node.arcs[i - 1] = node.arcs[i];
+        node.focusX[i - 1] = node.focusX[i];
+        node.focusY[i - 1] = node.focusY[i];
+    }
+    --node.size;
+    if (node.size == 0)
+        removeLeaf(leaf);
+    // Update next and prev
+    if (!isNil(z->prev))
+        z->prev->next = z->next;
+    if (!isNil(z->next))
+        z->next->prev = z->prev;
+    // Update the breakpoint that changed
+    updateSeparator(z->next);
+    moveFinger(z, isNil(z->prev) ? z->next : z->prev);
+}
+
+unsigned int BTreeBeachline::createLeaf()
+{
+    unsigned int leaf;
+    if (!mFreeLeaves.empty())
+    {
+        leaf = mFreeLeaves.back();
+        mFreeLeaves.resize(mFreeLeaves.size() - 1);
+    }
+    else
+        leaf = mLeaves.allocate(1);
+    mLeaves[leaf].size = 0;
+    mLeaves[leaf].parent = NONE;
+    return leaf;
+}
+
+unsigned int BTreeBeachline::createInner()
+{
+    unsigned int inner;
+    if (!mFreeInners.empty())
+    {
+        inner = mFreeInners.back();
+        mFreeInners.resize(mFreeInners.size() - 1);
+    }
+    else
+        inner = mInners.allocate(1);
+    mInners[inner].size = 0;
+    mInners[inner].parent = NONE;
+    return inner;
+}
+
+// Leaves are at height 0
+unsigned int& BTreeBeachline::getParent(unsigned int node, unsigned int height)
+{
+    return height == 0 ? mLeaves[node].parent : mInners[node].parent;
+}
+
+unsigned int BTreeBeachline::getChildIndex(const Inner& inner, unsigned int child) const
+{
+    unsigned int i = 0;
+    while (inner.children[i] != child)
+        ++i;
+    return i;
+}
+
+unsigned int BTreeBeachline::getArcIndex(const Leaf& leaf, const Arc* x) const
+{
+    unsigned int i = 0;
+    while (leaf.arcs[i] != x)
+        ++i;
+    return i;
+}
+
+// Breakpoint on the left of first, the leftmost arc has an empty breakpoint with itself
+BTreeBeachline::Separator BTreeBeachline::getSeparator(const Arc* first) const
+{
+    const Arc* prev = isNil(first->prev) ? first : first->prev;
+    return Separator{prev->focusX, prev->focusY, first->focusX, first->focusY};
+}
+
+BTreeBeachline::Separator BTreeBeachline::getSeparator(unsigned int node, unsigned int height) const
+{
+    return height == 0 ? getSeparator(mLeaves[node].arcs[0]) : mInners[node].separators[0];
+}
+
+// Insert y at index i in leaf, the pointers of the arcs are set by the caller
+void BTreeBeachline::insert(unsigned int leaf, unsigned int i, Arc* y)
+{
+    if (mLeaves[leaf].size == LEAF_CAPACITY)
+    {
+        unsigned int right = splitLeaf(leaf);
+        unsigned int leftSize = mLeaves[leaf].size;
+        if (i > leftSize)
+        {
+            i -= leftSize;
+            leaf = right;
+        }
+    }
+    Leaf& node = mLeaves[leaf];
+    for (unsigned int j = node.size; j > i; --j)
+    {
+        node.arcs[j] = node.arcs[j - 1];
+        node.focusX[j] = node.focusX[j - 1];
+        node.focusY[j] = node.focusY[j - 1];
+    }
+    node.arcs[i] = y;
+    node.focusX[i] = y->focusX;
+    node.focusY[i] = y->focusY;
+    ++node.size;
+    y->position = leaf;
+}
+
+// Insert newChild right after child in parent, both children have the given height
+void BTreeBeachline::insertChild(unsigned int parent, unsigned int child, unsigned int newChild, unsigned int height)
+{
+    // The root was split, grow the tree
+    if (parent == NONE)
+    {
+        Separator childSeparator = getSeparator(child, height);
+        Separator newChildSeparator = getSeparator(newChild, height);
+        mRoot = createInner();
+        mHeight = height + 1;
+        Inner& root = mInners[mRoot];
+        root.size = 2;
+        root.children[0] = child;
+        root.children[1] = newChild;
+        root.separators[0] = childSeparator;
+        root.separators[1] = newChildSeparator;
+        getParent(child, height) = mRoot;
+        getParent(newChild, height) = mRoot;
+        return;
+    }
+    if (mInners[parent].size == INNER_CAPACITY)
+    {
+        unsigned int right = splitInner(parent, height + 1);
+        if (getParent(child, height) == right)
+            parent = right;
+    }
+    Separator separator = getSeparator(newChild, height);
+    Inner& node = mInners[parent];
+    unsigned int i = getChildIndex(node, child) + 1;
+    for (unsigned int j = node.size; j > i; --j)
+    {
+        node.children[j] = node.children[j - 1];
+        node.separators[j] = node.separators[j - 1];
+    }
+    node.children[i] = newChild;
+    node.separators[i] = separator;
+    ++node.size;
+    getParent(newChild, height) = parent;
+}
+
+// Move the second half of the arcs of leaf in a new leaf and return it
+unsigned int BTreeBeachline::splitLeaf(unsigned int leaf)
+{
+    unsigned int right = createLeaf();
+    Leaf& leftNode = mLeaves[leaf];
+    Leaf& rightNode = mLeaves[right];
+    unsigned int half = leftNode.size / 2;
+    for (unsigned int i = half; i < leftNode.size; ++i)
+    {
+        rightNode.arcs[i - half] = leftNode.arcs[i];
+        rightNode.focusX[i - half] = leftNode.focusX[i];
+        rightNode.focusY[i - half] = leftNode.focusY[i];
+        leftNode.arcs[i]->position = right;
+    }
+    rightNode.size = leftNode.size - half;
+    leftNode.size = half;
+    insertChild(leftNode.parent, leaf, right, 0);
+    return right;
+}
+
+// Move the second half of the children of inner in a new node and return it
+unsigned int BTreeBeachline::splitInner(unsigned int inner, unsigned int height)
+{
+    unsigned int right = createInner();
+    Inner& leftNode = mInners[inner];
+    Inner& rightNode = mInners[right];
+    unsigned int half = leftNode.size / 2;
+    for (unsigned int i = half; i < leftNode.size; ++i)
+    {
+        rightNode.children[i - half] = leftNode.children[i];
+        rightNode.separators[i - half] = leftNode.separators[i];
+        getParent(leftNode.children[i], height - 1) = right;
+    }
+    rightNode.size = leftNode.size - half;
+    leftNode.size = half;
+    insertChild(leftNode.parent, inner, right, height);
+    return right;
+}
+
+// Free an empty leaf and the ancestors that become empty
+void BTreeBeachline::removeLeaf(unsigned int leaf)
+{
+    unsigned int node = leaf;
+    unsigned int height = 0;
+    bool isEmptyNode = true;
+    while (isEmptyNode)
+    {
+        unsigned int parent = getParent(node, height);
+        if (height == 0)
+            mFreeLeaves.push_back(node);
+        else
+            mFreeInners.push_back(node);
+        if (parent == NONE)
+        {
+            mRoot = NONE;
+            mHeight = 0;
+            return;
+        }
+        Inner& parentNode = mInners[parent];
+        for (unsigned int i = getChildIndex(parentNode, node) + 1; i < parentNode.size; ++i)
+        {
+            parentNode.children[i - 1] = parentNode.children[i];
+            parentNode.separators[i - 1] = parentNode.separators[i];
+        }
+        --parentNode.size;
+        isEmptyNode = parentNode.size == 0;
+        node = parent;
+        ++height;
+    }
+    // Shorten the tree while the root has a single child
+    while (mHeight > 0 && mInners[mRoot].size == 1)
+    {
+        mFreeInners.push_back(mRoot);
+        mRoot = mInners[mRoot].children[0];
+        --mHeight;
+        getParent(mRoot, mHeight) = NONE;
+    }
+}
+
+// To call when the arc before x changed or x was inserted, only the first arcs of the leaves are stored in separators
+void BTreeBeachline::updateSeparator(const Arc* x)
+{
+    if (isNil(x) || mLeaves[x->position].arcs[0] != x)
+        return;
+    Separator separator = getSeparator(x);
+    unsigned int node = x->position;
+    unsigned int parent = mLeaves[node].parent;
+    while (parent != NONE)
+    {
+        Inner& parentNode = mInners[parent];
+        unsigned int i = getChildIndex(parentNode, node);
+        parentNode.separators[i] = separator;
+        // The separator is also the one of the parent if x is the leftmost arc of its subtree
+        if (i != 0)
+            break;
+        node = parent;
+        parent = parentNode.parent;
+    }
+}
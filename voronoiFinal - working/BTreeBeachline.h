@@ -0,0 +1,88 @@
+#pragma once
+
+// My includes
+#include "Vector2.h"
+#include "VoronoiDiagram.h"
+#include "BeachlineBase.h"
+#include "IndexPool.h"
+
+struct Arc;
+
+// B+-tree of arcs. The leaves pack the arcs with their foci and the inner nodes keep the foci
+// around the leftmost breakpoint of each child, so a search only reads the nodes on its path.
+// Nodes are only freed when they become empty, the beachline shrinks too little for merges to pay off.
+class BTreeBeachline : public BeachlineBase
+{
+public:
+    explicit BTreeBeachline(MemoryResource* resource = nullptr);
+
+    // Remove all the arcs but keep their storage
+    void clear();
+
+    bool isEmpty() const;
+    void setRoot(Arc* x);
+    Arc* getLeftmostArc() const;
+
+    Arc* locateArcAbove(const Vector2& point, double l);
+    void insertBefore(Arc* x, Arc* y);
+    void insertAfter(Arc* x, Arc* y);
+    void replace(Arc* x, Arc* y);
+    void remove(Arc* z);
+
+private:
+    static constexpr unsigned int NONE = 0xFFFFFFFF;
+    static constexpr unsigned int LEAF_CAPACITY = 32;
+    static constexpr unsigned int INNER_CAPACITY = 16;
+
+    // Foci of the arcs on both sides of a breakpoint
+    struct Separator
+    {
+        double leftX;
+        double leftY;
+        double rightX;
+        double rightY;
+    };
+
+    // Arc::position is the index of the leaf of the arc
+    struct Leaf
+    {
+        unsigned int size;
+        unsigned int parent;
+        Arc* arcs[LEAF_CAPACITY];
+        double focusX[LEAF_CAPACITY];
+        double focusY[LEAF_CAPACITY];
+    };
+
+    // separators[i] is the breakpoint on the left of the subtree of children[i]
+    struct Inner
+    {
+        unsigned int size;
+        unsigned int parent;
+        unsigned int children[INNER_CAPACITY];
+        Separator separators[INNER_CAPACITY];
+    };
+
+    IndexPool<Leaf> mLeaves;
+    IndexPool<Inner> mInners;
+    IndexPool<unsigned int> mFreeLeaves;
+    IndexPool<unsigned int> mFreeInners;
+    unsigned int mRoot; // Leaf if mHeight is 0, inner node otherwise
+    unsigned int mHeight;
+
+    // Nodes
+    unsigned int createLeaf();
+    unsigned int createInner();
+    unsigned int& getParent(unsigned int node, unsigned int height);
+    unsigned int getChildIndex(const Inner& inner, unsigned int child) const;
+    unsigned int getArcIndex(const Leaf& leaf, const Arc* x) const;
+    Separator getSeparator(const Arc* first) const;
+    Separator getSeparator(unsigned int node, unsigned int height) const;
+
+    // Updates
+    void insert(unsigned int leaf, unsigned int i, Arc* y);
+    void insertChild(unsigned int parent, unsigned int child, unsigned int newChild, unsigned int height);
+    unsigned int splitLeaf(unsigned int leaf);
+    unsigned int splitInner(unsigned int inner, unsigned int height);
+    void removeLeaf(unsigned int leaf);
+    void updateSeparator(const Arc* x);
+};
@@ -0,0 +1,176 @@
+#include "BatchFortuneAlgorithm.h"
+// STL
+#include <atomic>
+
+template<typename BeachlineType>
+BasicBatchFortuneAlgorithm<BeachlineType>::BasicBatchFortuneAlgorithm(Box box, unsigned int nbThreads, MemoryResource* resource,
+    MemoryResource* const* workerResources) :
+    mBox(box), mThreadPool(nbThreads, resource), mResource(resource != nullptr ? resource : getDefaultMemoryResource()),
+    mWorkers(nullptr), mNbWorkers(mThreadPool.getNbThreads()), mNbDiagrams(0), mSources(resource), mValidDiagrams(resource),
+    mCellOffsets(resource), mX(resource), mY(resource)
+{
+    // The workers are built at once with their resources, they allocate nothing before their first diagram
+    mWorkers = static_cast<Worker*>(mResource->allocate(mNbWorkers * sizeof(Worker), alignof(Worker)));
+    for (unsigned int i = 0; i < mNbWorkers; ++i)
+        new (mWorkers + i) Worker(workerResources != nullptr ? workerResources[i] : nullptr);
+}
+
+template<typename BeachlineType>
+BasicBatchFortuneAlgorithm<BeachlineType>::~BasicBatchFortuneAlgorithm()
+{
+    for (unsigned int i = 0; i < mNbWorkers; ++i)
+        mWorkers[i].~Worker();
+    mResource->deallocate(mWorkers, mNbWorkers * sizeof(Worker), alignof(Worker));
+}
+
+template<typename BeachlineType>
+unsigned int BasicBatchFortuneAlgorithm<BeachlineType>::construct(PointSpan points, const unsigned int* offsets, unsigned int nbDiagrams)
+{
+    unsigned int nbTasks = (nbDiagrams + DIAGRAMS_PER_TASK - 1) / DIAGRAMS_PER_TASK;
+    unsigned int nbWorkers = mNbWorkers;
+    if (nbWorkers > nbTasks)
+        nbWorkers = nbTasks > 0 ? nbTasks : 1;
+    mNbDiagrams = nbDiagrams;
+    mSources.resize(nbDiagrams);
+    mValidDiagrams.resize(nbDiagrams);
+    unsigned int nbCells = nbDiagrams > 0 ? offsets[nbDiagrams] : 0;
+    mCellOffsets.resize(nbCells + 1);
+    for (unsigned int i = 0; i < (nbDiagrams > 0 ? offsets[0] : 0); ++i)
+        mCellOffsets[i] = 0;
+
+    // Each worker builds the diagrams of the tasks it takes and writes the sizes of their cells
+    std::atomic<unsigned int> nextDiagram(0);
+    std::atomic<unsigned int> nbInvalidDiagrams(0);
+    mThreadPool.parallelFor(nbWorkers, [this, points, offsets, nbDiagrams, &nextDiagram, &nbInvalidDiagrams](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            Worker& worker = mWorkers[i];
+            worker.x.clear();
+            worker.y.clear();
+            unsigned int nbWorkerInvalidDiagrams = 0;
+            while (true)
+            {
+                unsigned int first = nextDiagram.fetch_add(DIAGRAMS_PER_TASK);
+                if (first >= nbDiagrams)
+                    break;
+                unsigned int last = first + DIAGRAMS_PER_TASK < nbDiagrams ? first + DIAGRAMS_PER_TASK : nbDiagrams;
+                for (unsigned int j = first; j < last; ++j)
+                {
+                    mSources[j] = Source{i, worker.x.size()};
+                    mValidDiagrams[j] = buildDiagram(worker, points.getSubspan(offsets[j], offsets[j + 1] - offsets[j]), offsets[j]);
+                    if (!mValidDiagrams[j])
+                        ++nbWorkerInvalidDiagrams;
+                }
+            }
+            nbInvalidDiagrams += nbWorkerInvalidDiagrams;
+        }
+    }, 1);
+    unsigned int nbVertices = 0;
+    for (unsigned int i = 0; i < nbCells; ++i)
+    {
+        unsigned int size = mCellOffsets[i];
+        mCellOffsets[i] = nbVertices;
+        nbVertices += size;
+    }
+    mCellOffsets[nbCells] = nbVertices;
+
+    // Then the cells of the diagrams are gathered
+    mX.resize(nbVertices);
+    mY.resize(nbVertices);
+    mThreadPool.parallelFor(nbDiagrams, [this, offsets](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            const Worker& worker = mWorkers[mSources[i].worker];
+            unsigned int first = mCellOffsets[offsets[i]];
+            unsigned int size = mCellOffsets[offsets[i + 1]] - first;
+            for (unsigned int j = 0; j < size; ++j)
+            {
+                mX[first + j] = worker.x[mSources[i].first + j];
+                mY[first + j] = worker.y[mSources[i].first + j];
+            }
+        }
+    });
+    return nbInvalidDiagrams;
+}
+
+template<typename BeachlineType>
+unsigned int BasicBatchFortuneAlgorithm<BeachlineType>::getNbDiagrams() const
+{
+    return mNbDiagrams;
+}
+
+template<typename BeachlineType>
+bool BasicBatchFortuneAlgorithm<BeachlineType>::isValid(unsigned int diagram) const
+{
+    return mValidDiagrams[diagram];
+}
+
+template<typename BeachlineType>
+unsigned int BasicBatchFortuneAlgorithm<BeachlineType>::getNbCellVertices(unsigned int site) const
+{
+    return mCellOffsets[site + 1] - mCellOffsets[site];
+}
+
+template<typename BeachlineType>
+const double* BasicBatchFortuneAlgorithm<BeachlineType>::getCellX(unsigned int site) const
+{
+    return mX.mData + mCellOffsets[site];
+}
+
+template<typename BeachlineType>
+const double* BasicBatchFortuneAlgorithm<BeachlineType>::getCellY(unsigned int site) const
+{
+    return mY.mData + mCellOffsets[site];
+}
+
+// Builds one diagram with the storage of the worker and appends its cells to the worker's buffers
+template<typename BeachlineType>
+bool BasicBatchFortuneAlgorithm<BeachlineType>::buildDiagram(Worker& worker, PointSpan sites, unsigned int firstCell)
+{
+    unsigned int nbSites = sites.size();
+    // A sweep needs two sites, the cell of a single site is the box
+    if (nbSites < 2)
+    {
+        if (nbSites == 1)
+        {
+            worker.x.push_back(mBox.left);
+            worker.y.push_back(mBox.bottom);
+            worker.x.push_back(mBox.right);
+            worker.y.push_back(mBox.bottom);
+            worker.x.push_back(mBox.right);
+            worker.y.push_back(mBox.top);
+            worker.x.push_back(mBox.left);
+            worker.y.push_back(mBox.top);
+            mCellOffsets[firstCell] = 4;
+        }
+        return true;
+    }
+
+    worker.algorithm.reset(sites);
+    bool isValid = worker.algorithm.constructClipped(mBox, worker.diagram);
+
+    // The cells have at most as many vertices in all as the diagram has half edges
+    unsigned int first = worker.x.size();
+    unsigned int end = first + (isValid ? worker.diagram.getHalfEdges().size() : 0);
+    worker.x.resize(end);
+    worker.y.resize(end);
+    unsigned int size = first;
+    for (unsigned int i = 0; i < nbSites; ++i)
+    {
+        unsigned int nbVertices = 0;
+        if (isValid)
+            nbVertices = worker.diagram.copyFaceVertices(i, worker.x.mData + size, worker.y.mData + size, end - size);
+        mCellOffsets[firstCell + i] = nbVertices;
+        size += nbVertices;
+    }
+    worker.x.resize(size);
+    worker.y.resize(size);
+    return isValid;
+}
+
+// Instantiations for the available beachlines
+template class BasicBatchFortuneAlgorithm<Beachline>;
+template class BasicBatchFortuneAlgorithm<FlatBeachline>;
+template class BasicBatchFortuneAlgorithm<BTreeBeachline>;
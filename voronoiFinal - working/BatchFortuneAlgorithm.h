@@ -0,0 +1,87 @@
+#pragma once
+
+// My includes
+#include "FortuneAlgorithm.h"
+#include "ParallelFor.h"
+
+// Many small independent diagrams built, bounded and clipped to the same box, e.g. millions of
+// diagrams of a few dozen sites where the cost of setting up a construction matters more than
+// the geometry. Each worker thread keeps its own algorithm and diagram and reuses their storage
+// from one diagram to the next, it takes the diagrams by tasks from a shared counter so that the
+// threads that finish early take more. The cells are then gathered in one packed buffer, in the
+// order of the sites.
+//
+// The threads are started once with the batch. Their array, the packed buffer and the bookkeeping
+// take their memory from the resource of the batch, only from the thread that builds the batch and
+// calls construct. A worker takes all its memory from its own resource so that the resources of
+// the workers do not need to be thread safe either.
+template<typename BeachlineType = Beachline>
+class BasicBatchFortuneAlgorithm
+{
+public:
+    // Diagrams taken at once by a worker
+    static constexpr unsigned int DIAGRAMS_PER_TASK = 64;
+
+    // nbThreads = 0 uses all the hardware threads. workerResources, if not nullptr, holds one resource
+    // per thread, getNbThreads(nbThreads) of them. nullptr takes the memory from the default resource
+    BasicBatchFortuneAlgorithm(Box box, unsigned int nbThreads = 0, MemoryResource* resource = nullptr,
+        MemoryResource* const* workerResources = nullptr);
+    ~BasicBatchFortuneAlgorithm();
+
+    // Remove copy operations
+    BasicBatchFortuneAlgorithm(const BasicBatchFortuneAlgorithm&) = delete;
+    BasicBatchFortuneAlgorithm& operator=(const BasicBatchFortuneAlgorithm&) = delete;
+
+    // Builds the diagrams of the point sets, the sites of diagram i are the points offsets[i] to
+    // offsets[i + 1] - 1. The sites of a diagram must be distinct and inside the box.
+    // Returns the number of diagrams that could not be clipped, their cells are empty
+    unsigned int construct(PointSpan points, const unsigned int* offsets, unsigned int nbDiagrams);
+
+    // Accessors
+    unsigned int getNbDiagrams() const;
+    bool isValid(unsigned int diagram) const;
+    // A cell is given by the index of its site in the points, its vertices are counterclockwise
+    unsigned int getNbCellVertices(unsigned int site) const;
+    const double* getCellX(unsigned int site) const;
+    const double* getCellY(unsigned int site) const;
+
+private:
+    struct Worker
+    {
+        explicit Worker(MemoryResource* resource) : algorithm(resource), diagram(resource), x(resource), y(resource)
+        {
+
+        }
+
+        BasicFortuneAlgorithm<BeachlineType> algorithm;
+        VoronoiDiagram diagram;
+        // Cells of the diagrams built by the worker, one after the other
+        IndexPool<double> x;
+        IndexPool<double> y;
+    };
+
+    // Where the cells of a diagram are before they are gathered
+    struct Source
+    {
+        unsigned int worker;
+        unsigned int first;
+    };
+
+    Box mBox;
+    ThreadPool mThreadPool;
+    MemoryResource* mResource;
+    // One worker per thread
+    Worker* mWorkers;
+    unsigned int mNbWorkers;
+    unsigned int mNbDiagrams;
+    IndexPool<Source> mSources;
+    IndexPool<bool> mValidDiagrams;
+    // Packed cells, the vertices of the cell of site i are mCellOffsets[i] to mCellOffsets[i + 1] - 1
+    IndexPool<unsigned int> mCellOffsets;
+    IndexPool<double> mX;
+    IndexPool<double> mY;
+
+    bool buildDiagram(Worker& worker, PointSpan sites, unsigned int firstCell);
+};
+
+using BatchFortuneAlgorithm = BasicBatchFortuneAlgorithm<Beachline>;
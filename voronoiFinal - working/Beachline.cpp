@@ -1,23 +1,16 @@
 #include "Beachline.h"
 #include "Arc.h"
-#define INFINITY  ((unsigned) ~0)
-#define NEGATIVEINFINITY (-214748364)
 
 
-Beachline::Beachline() : mNil(new Arc), mRoot(mNil)
+Beachline::Beachline(MemoryResource* resource) : BeachlineBase(resource), mRoot(mNil)
 {
-    mNil->color = Arc::Color::BLACK; 
-}
 
-Beachline::~Beachline()
-{
-    free(mRoot);    
-    delete mNil;
 }
 
-Arc* Beachline::createArc(VoronoiDiagram::Site* site)
+void Beachline::clear()
 {
-    return new Arc{mNil, mNil, mNil, site, nullptr, nullptr, nullptr, mNil, mNil, Arc::Color::RED};
+    mRoot = mNil;
+    clearArcs();
 }
 
 bool Beachline::isEmpty() const
@@ -25,11 +18,6 @@ bool Beachline::isEmpty() const
     return isNil(mRoot);
 }
 
-bool Beachline::isNil(const Arc* x) const
-{
-    return x == mNil;
-}
-
 void Beachline::setRoot(Arc* x)
 {
     mRoot = x;
@@ -44,25 +32,25 @@ Arc* Beachline::getLeftmostArc() const
     return x;
 }
 
-Arc* Beachline::locateArcAbove(const Vector2& point, double l) const
+Arc* Beachline::locateArcAbove(const Vector2& point, double l)
 {
-    Arc* node = mRoot;
+    // Try the finger first, otherwise descend from the root
+    Arc* node = walkFromFinger(point.x, l);
+    if (node != nullptr)
+        return node;
+    node = mRoot;
     bool found = false;
     while (!found)
     {
-        double breakpointLeft = NEGATIVEINFINITY;
-        double breakpointRight = INFINITY;
-        if (!isNil(node->prev))
-           breakpointLeft =  computeBreakpoint(node->prev->site->point, node->site->point, l);
-        if (!isNil(node->next))
-            breakpointRight = computeBreakpoint(node->site->point, node->next->site->point, l);
-        if (point.x < breakpointLeft)
+        int side = compareToBreakpoints(point.x, node, l);
+        if (side < 0)
             node = node->left;
-        else if (point.x > breakpointRight)
+        else if (side > 0)
             node = node->right;
         else
             found = true;
     }
+    setFinger(node);
     return node;
 }
 
@@ -128,6 +116,7 @@ void Beachline::replace(Arc* x, Arc* y)
     if (!isNil(y->next))
         y->next->prev = y;
     y->color = x->color;
+    moveFinger(x, y);
 }
 
 void Beachline::remove(Arc* z)
@@ -170,9 +159,9 @@ void Beachline::remove(Arc* z)
         z->prev->next = z->next;
     if (!isNil(z->next))
         z->next->prev = z->prev;
+    moveFinger(z, isNil(z->prev) ? z->next : z->prev);
 }
 
-
 Arc* Beachline::minimum(Arc* x) const
 {
     while (!isNil(x->left))
@@ -362,52 +351,3 @@ void Beachline::rightRotate(Arc* y)
     x->right = y;
     y->parent = x;
 }
-double Beachline::squareRoot(double n) const {
-	if (n < 0) {
-		return 0;
-	}
-	if (n > 1) {
-		double error = 0.00001; //define the precision of your result
-		double s = n;
-
-		while ((s - n / s) > error) //loop until precision satisfied 
-		{
-			s = (s + n / s) / 2;
-		}
-		return s;
-	}
-	else {
-		double temp = 0;
-		double sqrt = n / 2;
-		while (sqrt != temp)
-		{
-			temp = sqrt;
-			sqrt = (n / sqrt + sqrt) / 2;
-		}
-		return sqrt;
-	}
-}
-
-double Beachline::computeBreakpoint(const Vector2& point1, const Vector2& point2, double l) const
-{
-    double x1 = point1.x, y1 = point1.y, x2 = point2.x, y2 = point2.y;
-    double d1 = 1.0 / (2.0 * (y1 - l));
-	double d2 = 1.0 / (2.0 * (y2 - l));
-	double a = d1 - d2;
-	double b = 2.0 * (x2 * d2 - x1 * d1);
-	double c = (y1 * y1 + x1 * x1 - l * l) * d1 - (y2 * y2 + x2 * x2 - l * l) * d2;
-	double delta = b * b - 4.0 * a * c;
-    return (-b + squareRoot(delta)) / (2.0 * a);
-}
-
-void Beachline::free(Arc* x)
-{
-    if (isNil(x))
-        return;
-    else
-    {
-        free(x->left);
-        free(x->right);
-        delete x;
-    }
-}
@@ -3,40 +3,32 @@
 // My includes
 #include "Vector2.h"
 #include "VoronoiDiagram.h"
+#include "BeachlineBase.h"
 
 struct Arc;
 
-class Beachline
+// Red-black tree of arcs, the default beachline
+class Beachline : public BeachlineBase
 {
 public:
-    Beachline();
-    ~Beachline();
+    explicit Beachline(MemoryResource* resource = nullptr);
 
-    // Remove copy and move operations
-    Beachline(const Beachline&) = delete;
-    Beachline& operator=(const Beachline&) = delete;
-    Beachline(Beachline&&) = delete;
-    Beachline& operator=(Beachline&&) = delete;
+    // Remove all the arcs but keep their storage
+    void clear();
 
-    Arc* createArc(VoronoiDiagram::Site* site);
-    
     bool isEmpty() const;
-    bool isNil(const Arc* x) const;
     void setRoot(Arc* x);
     Arc* getLeftmostArc() const;
 
-    Arc* locateArcAbove(const Vector2& point, double l) const;
+    Arc* locateArcAbove(const Vector2& point, double l);
     void insertBefore(Arc* x, Arc* y);
     void insertAfter(Arc* x, Arc* y);
     void replace(Arc* x, Arc* y);
     void remove(Arc* z);
 
-	double squareRoot(double n) const;
-
 
 
 private:
-    Arc* mNil;
     Arc* mRoot;
 
     // Utility methods
@@ -50,10 +42,5 @@ private:
     // Rotations
     void leftRotate(Arc* x);
     void rightRotate(Arc* y);
-
-    double computeBreakpoint(const Vector2& point1, const Vector2& point2, double l) const;
-
-    void free(Arc* x);
-
 };
 
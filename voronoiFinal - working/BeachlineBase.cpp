@@ -0,0 +1,130 @@
+#include "BeachlineBase.h"
+#include "Arc.h"
+// SIMD
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BEACHLINE_SSE2
+#include <emmintrin.h>
+#endif
+
+BeachlineBase::BeachlineBase(MemoryResource* resource) : mNilArc(), mNil(&mNilArc), mArcs(resource), mFinger(mNil), mFingerBackoff(0), mFingerSkips(0)
+{
+    mNil->color = Arc::Color::BLACK;
+}
+
+BeachlineBase::~BeachlineBase() = default;
+
+Arc* BeachlineBase::createArc(VoronoiDiagram::Site* site)
+{
+    return mArcs.create(site, mNil);
+}
+
+void BeachlineBase::deleteArc(Arc* x)
+{
+    moveFinger(x, mNil);
+    mArcs.release(x);
+}
+
+bool BeachlineBase::isNil(const Arc* x) const
+{
+    return x == mNil;
+}
+
+void BeachlineBase::clearArcs()
+{
+    mArcs.clear();
+    mFinger = mNil;
+    mFingerBackoff = 0;
+    mFingerSkips = 0;
+}
+
+// Spatially coherent sites fall near the previous one, walk there from the finger.
+// Returns nullptr if the arc above x is not close enough to the finger.
+Arc* BeachlineBase::walkFromFinger(double x, double l)
+{
+    if (mFingerSkips > 0)
+    {
+        --mFingerSkips;
+        return nullptr;
+    }
+    if (isNil(mFinger))
+        return nullptr;
+    Arc* node = mFinger;
+    int side = compareToBreakpoints(x, node, l);
+    for (unsigned int i = 0; side != 0 && i < FINGER_WALK_LENGTH; ++i)
+    {
+        // The neighbor exists because a missing one never gives a side
+        Arc* neighbor = side < 0 ? node->prev : node->next;
+        int neighborSide = compareToBreakpoints(x, neighbor, l);
+        if (neighborSide == -side)
+            break;
+        node = neighbor;
+        side = neighborSide;
+    }
+    if (side == 0)
+    {
+        mFinger = node;
+        mFingerBackoff = 0;
+        return node;
+    }
+    mFingerBackoff = mFingerBackoff == 0 ? 1 : (mFingerBackoff < MAX_FINGER_BACKOFF ? 2 * mFingerBackoff : MAX_FINGER_BACKOFF);
+    mFingerSkips = mFingerBackoff;
+    return nullptr;
+}
+
+void BeachlineBase::setFinger(Arc* x)
+{
+    mFinger = x;
+}
+
+// To call when x is replaced by or merged into y
+void BeachlineBase::moveFinger(const Arc* x, Arc* y)
+{
+    if (x == mFinger)
+        mFinger = y;
+}
+
+// Tells on which side of the breakpoints of arc the abscissa x is: -1 if x is left of
+// the left breakpoint, 1 if x is right of the right breakpoint and 0 if x is under the arc.
+// Both breakpoints are tested at once with the formula of compareToBreakpoint.
+//
+// A missing neighbor is replaced by the arc itself: then f = u = 0 and x is neither before
+// nor after the breakpoint.
+int BeachlineBase::compareToBreakpoints(double x, const Arc* arc, double l) const
+{
+    const Arc* prev = isNil(arc->prev) ? arc : arc->prev;
+    const Arc* next = isNil(arc->next) ? arc : arc->next;
+#ifdef BEACHLINE_SSE2
+    // Lane 0 is the left breakpoint (prev, arc), lane 1 the right one (arc, next)
+    __m128d vx = _mm_set1_pd(x);
+    __m128d vl = _mm_set1_pd(l);
+    __m128d zero = _mm_setzero_pd();
+    __m128d x1 = _mm_set_pd(arc->focusX, prev->focusX);
+    __m128d y1 = _mm_set_pd(arc->focusY, prev->focusY);
+    __m128d x2 = _mm_set_pd(next->focusX, arc->focusX);
+    __m128d y2 = _mm_set_pd(next->focusY, arc->focusY);
+    __m128d e1 = _mm_sub_pd(y1, vl);
+    __m128d e2 = _mm_sub_pd(y2, vl);
+    __m128d dx1 = _mm_sub_pd(vx, x1);
+    __m128d dx2 = _mm_sub_pd(vx, x2);
+    __m128d p1 = _mm_add_pd(_mm_mul_pd(dx1, dx1), _mm_mul_pd(e1, _mm_add_pd(y1, vl)));
+    __m128d p2 = _mm_add_pd(_mm_mul_pd(dx2, dx2), _mm_mul_pd(e2, _mm_add_pd(y2, vl)));
+    __m128d f = _mm_sub_pd(_mm_mul_pd(p1, e2), _mm_mul_pd(p2, e1));
+    __m128d u = _mm_sub_pd(_mm_mul_pd(dx1, e2), _mm_mul_pd(dx2, e1));
+    __m128d uNeg = _mm_cmplt_pd(u, zero);
+    __m128d uPos = _mm_cmpgt_pd(u, zero);
+    __m128d fNeg = _mm_cmplt_pd(f, zero);
+    __m128d fPos = _mm_cmpgt_pd(f, zero);
+    __m128d isOpenUpward = _mm_cmple_pd(e1, e2);
+    __m128d isBefore = _mm_or_pd(_mm_and_pd(isOpenUpward, _mm_or_pd(uNeg, fNeg)),
+        _mm_andnot_pd(isOpenUpward, _mm_and_pd(uPos, fNeg)));
+    __m128d isAfter = _mm_or_pd(_mm_and_pd(isOpenUpward, _mm_and_pd(uPos, fPos)),
+        _mm_andnot_pd(isOpenUpward, _mm_or_pd(uNeg, fPos)));
+    if (_mm_movemask_pd(isBefore) & 1)
+        return -1;
+    return (_mm_movemask_pd(isAfter) & 2) ? 1 : 0;
+#else
+    if (compareToBreakpoint(x, prev->focusX, prev->focusY, arc->focusX, arc->focusY, l) < 0)
+        return -1;
+    return compareToBreakpoint(x, arc->focusX, arc->focusY, next->focusX, next->focusY, l) > 0 ? 1 : 0;
+#endif
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+// My includes
+#include "VoronoiDiagram.h"
+#include "ArcPool.h"
+
+struct Arc;
+
+// Storage of the arcs, finger search and breakpoint tests shared by the beachlines.
+// A beachline only chooses how the arcs are ordered, every one of them also threads
+// the arcs through Arc::prev and Arc::next with mNil at both ends.
+class BeachlineBase
+{
+public:
+    // Remove copy and move operations
+    BeachlineBase(const BeachlineBase&) = delete;
+    BeachlineBase& operator=(const BeachlineBase&) = delete;
+    BeachlineBase(BeachlineBase&&) = delete;
+    BeachlineBase& operator=(BeachlineBase&&) = delete;
+
+    Arc* createArc(VoronoiDiagram::Site* site);
+    void deleteArc(Arc* x);
+
+    bool isNil(const Arc* x) const;
+
+    // Sign of x minus the breakpoint between the arcs of the foci (x1, y1) and (x2, y2) when the
+    // sweep line is at l, also used by FixedFortuneAlgorithm
+    static constexpr int compareToBreakpoint(double x, double x1, double y1, double x2, double y2, double l);
+
+protected:
+    // nullptr takes the arcs from the default resource
+    explicit BeachlineBase(MemoryResource* resource);
+    ~BeachlineBase();
+
+    // Number of arcs walked from the finger before falling back to a search from the root
+    static constexpr unsigned int FINGER_WALK_LENGTH = 4;
+    // Maximum number of locations done from the root after a miss of the finger
+    static constexpr unsigned int MAX_FINGER_BACKOFF = 64;
+
+    Arc mNilArc; // Stored inline so that a beachline allocates nothing but its arcs
+    Arc* mNil;
+    ArcPool mArcs;
+
+    // Forget all the arcs but keep their storage
+    void clearArcs();
+
+    // Finger search
+    Arc* walkFromFinger(double x, double l);
+    void setFinger(Arc* x);
+    void moveFinger(const Arc* x, Arc* y);
+
+    // Breakpoints
+    int compareToBreakpoints(double x, const Arc* arc, double l) const;
+
+private:
+    Arc* mFinger; // Last located arc, it follows the arc that replaces or absorbs it
+    unsigned int mFingerBackoff; // Doubles after each miss so that incoherent inputs rarely pay for the walk
+    unsigned int mFingerSkips; // Number of locations left before the finger is tried again
+};
+
+// Defined here to be inlined in the searches of the beachlines and in constant expressions. Let ei = yi - l, the parabola of focus i is
+// ((x - xi)^2 + yi^2 - l^2) / (2 * ei). f(x) = ((x - x1)^2 + y1^2 - l^2) * e2 - ((x - x2)^2 + y2^2 - l^2) * e1
+// is the difference of the two parabolas scaled by 2 * e1 * e2 >= 0, and u = (x - x1) * e2 - (x - x2) * e1
+// is the derivative of that difference scaled by e1 * e2, i.e. half the derivative of f. The breakpoint is the root of f taken by the
+// beachline, x is before it if u < 0 or f < 0 when e1 <= e2 (resp. u > 0 and f < 0 otherwise)
+// and after it if u > 0 and f > 0 (resp. u < 0 or f > 0). No reciprocal and no square root is needed.
+constexpr int BeachlineBase::compareToBreakpoint(double x, double x1, double y1, double x2, double y2, double l)
+{
+    double e1 = y1 - l;
+    double e2 = y2 - l;
+    double dx1 = x - x1;
+    double dx2 = x - x2;
+    double f = (dx1 * dx1 + e1 * (y1 + l)) * e2 - (dx2 * dx2 + e2 * (y2 + l)) * e1;
+    double u = dx1 * e2 - dx2 * e1;
+    bool isOpenUpward = e1 <= e2;
+    bool isBefore = isOpenUpward ? (u < 0.0 || f < 0.0) : (u > 0.0 && f < 0.0);
+    bool isAfter = isOpenUpward ? (u > 0.0 && f > 0.0) : (u < 0.0 || f > 0.0);
+    return isBefore ? -1 : (isAfter ? 1 : 0);
+}
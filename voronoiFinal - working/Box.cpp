@@ -47,7 +47,7 @@ Box::Intersection Box::getFirstIntersection(const Vector2& origin, const Vector2
     return intersection;
 }
 
-int Box::getIntersections(const Vector2& origin, const Vector2& destination, intersectionArray intersections) const
+int Box::getIntersections(const Vector2& origin, const Vector2& destination, intersectionArray& intersections) const
 {
     // WARNING: If the intersection is a corner, both intersections are equals
     Vector2 direction = destination - origin;
@@ -77,11 +77,11 @@ int Box::getIntersections(const Vector2& origin, const Vector2& destination, int
                 ++i;
         }
     }
-    // Bottom
-    if (origin.y < bottom - EPSILON || destination.y < bottom - EPSILON)
+    // Bottom, t only has room for two intersections
+    if (i < 2 && (origin.y < bottom - EPSILON || destination.y < bottom - EPSILON))
     {   
         t[i] = (bottom - origin.y) / direction.y;
-        if (i < 2 && t[i] > EPSILON && t[i] < 1.0 - EPSILON)  
+        if (t[i] > EPSILON && t[i] < 1.0 - EPSILON)  
         {
             intersections[i]->side = Side::BOTTOM;
             intersections[i]->point = origin + t[i] * direction;
@@ -90,10 +90,10 @@ int Box::getIntersections(const Vector2& origin, const Vector2& destination, int
         }
     }
     // Top
-    if (origin.y > top + EPSILON || destination.y > top + EPSILON)
+    if (i < 2 && (origin.y > top + EPSILON || destination.y > top + EPSILON))
     {   
         t[i] = (top - origin.y) / direction.y;
-        if (i < 2 && t[i] > EPSILON && t[i] < 1.0 - EPSILON)  
+        if (t[i] > EPSILON && t[i] < 1.0 - EPSILON)  
         {
             intersections[i]->side = Side::TOP;
             intersections[i]->point = origin + t[i] * direction;
@@ -16,25 +16,20 @@ public:
         Vector2 point;
     };
 
+	// Stored by value so that the owner can be moved freely
 	struct intersectionArray {
-		Intersection *first;
-		Intersection *second;
-
-		// Constructor
-		intersectionArray() {
-			first = new Intersection();
-			second = new Intersection();
-		}
+		Intersection first;
+		Intersection second;
 
 		// Operators
 		Intersection* operator[](unsigned int i) {
-			if (i == 0) return first;
-			else return second;
+			if (i == 0) return &first;
+			else return &second;
 		}
 
 		// Operations
 		void swap() {
-			Intersection *tmp = first;
+			Intersection tmp = first;
 			first = second;
 			second = tmp;
 		}
@@ -47,7 +42,7 @@ public:
 
     bool contains(const Vector2& point) const;
     Intersection getFirstIntersection(const Vector2& origin, const Vector2& direction) const; // Useful for Fortune's algorithm
-    int getIntersections(const Vector2& origin, const Vector2& destination, intersectionArray intersections) const; // Useful for diagram intersection
+    int getIntersections(const Vector2& origin, const Vector2& destination, intersectionArray& intersections) const; // Useful for diagram intersection
 
 private:
     static constexpr double EPSILON = 0.00000000000001;		// Replace with Teensy machine epsilon
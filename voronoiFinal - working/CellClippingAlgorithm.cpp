@@ -0,0 +1,308 @@
+#include "CellClippingAlgorithm.h"
+// My includes
+#include "Swap.h"
+
+// Relative margin on the squared distances to the vertices, a site almost as close as the site is
+// on the circle of the vertex and does not cut the cell
+constexpr double CIRCLE_TOLERANCE = 1e-12;
+
+// ClippedCell
+
+ClippedCell::ClippedCell(MemoryResource* resource) :
+    mSite(VoronoiDiagram::NONE), mVertices(resource), mNeighbors(resource), mClippedVertices(resource),
+    mClippedNeighbors(resource), mNearestSites(resource), mSquaredDistances(resource)
+{
+
+}
+
+unsigned int ClippedCell::getSite() const
+{
+    return mSite;
+}
+
+unsigned int ClippedCell::getNbVertices() const
+{
+    return mVertices.size();
+}
+
+const Vector2& ClippedCell::getVertex(unsigned int i) const
+{
+    return mVertices[i];
+}
+
+unsigned int ClippedCell::getNeighbor(unsigned int i) const
+{
+    return mNeighbors[i];
+}
+
+// CellClippingAlgorithm
+
+CellClippingAlgorithm::CellClippingAlgorithm(Box box, unsigned int nbThreads, MemoryResource* resource,
+    MemoryResource* const* threadResources) :
+    mBox(box), mThreadPool(nbThreads, resource), mResource(resource != nullptr ? resource : getDefaultMemoryResource()),
+    mPoints(static_cast<const double*>(nullptr), 0), mTree(&mThreadPool, resource), mDiagram(resource),
+    mFallback(resource), mUsedSweep(false), mChunks(nullptr), mNbChunks(mThreadPool.getNbThreads()), mSites(resource),
+    mRanks(resource), mStitcher(false, &mThreadPool, resource)
+{
+    // A chunk is computed by one thread at a time, the chunks allocate nothing before their first cell
+    mChunks = static_cast<Chunk*>(mResource->allocate(mNbChunks * sizeof(Chunk), alignof(Chunk)));
+    for (unsigned int i = 0; i < mNbChunks; ++i)
+        new (mChunks + i) Chunk(threadResources != nullptr ? threadResources[i] : nullptr);
+}
+
+CellClippingAlgorithm::~CellClippingAlgorithm()
+{
+    for (unsigned int i = 0; i < mNbChunks; ++i)
+        mChunks[i].~Chunk();
+    mResource->deallocate(mChunks, mNbChunks * sizeof(Chunk), alignof(Chunk));
+}
+
+void CellClippingAlgorithm::reset(PointSpan points)
+{
+    mPoints = points;
+    mTree.reset(points);
+    mRanks.resize(points.size());
+    mSites.resize(points.size());
+    mThreadPool.parallelFor(points.size(), [this](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            mSites[i] = mTree.getSite(i);
+            mRanks[mSites[i]] = i;
+        }
+    });
+}
+
+bool CellClippingAlgorithm::construct()
+{
+    unsigned int nbSites = mPoints.size();
+    unsigned int nbChunks = mNbChunks;
+    mUsedSweep = false;
+    if (nbChunks > nbSites / PARALLEL_MIN_BLOCK_SIZE)
+        nbChunks = nbSites / PARALLEL_MIN_BLOCK_SIZE > 0 ? nbSites / PARALLEL_MIN_BLOCK_SIZE : 1;
+
+    // Each chunk computes its cells in the order of the tree and writes their degrees
+    mStitcher.resizeCells(nbSites);
+    mThreadPool.parallelFor(nbChunks, [this, nbSites, nbChunks](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            Chunk& chunk = mChunks[i];
+            chunk.vertices.clear();
+            chunk.neighbors.clear();
+            for (unsigned int j = getChunkStart(nbSites, nbChunks, i); j < getChunkStart(nbSites, nbChunks, i + 1); ++j)
+            {
+                computeCell(mSites[j], chunk.cell);
+                unsigned int nbVertices = chunk.cell.getNbVertices();
+                unsigned int first = chunk.vertices.allocate(nbVertices);
+                chunk.neighbors.allocate(nbVertices);
+                for (unsigned int k = 0; k < nbVertices; ++k)
+                {
+                    unsigned int neighbor = chunk.cell.mNeighbors[k];
+                    chunk.vertices[first + k] = chunk.cell.mVertices[k];
+                    chunk.neighbors[first + k] = neighbor != NONE ? mRanks[neighbor] : NONE;
+                }
+                mStitcher.cellOffsets[j] = nbVertices;
+            }
+        }
+    }, 1);
+
+    // Then the chunks are copied one after the other
+    mStitcher.allocateSlots();
+    mThreadPool.parallelFor(nbChunks, [this, nbSites, nbChunks](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            const Chunk& chunk = mChunks[i];
+            unsigned int first = mStitcher.cellOffsets[getChunkStart(nbSites, nbChunks, i)];
+            for (unsigned int j = 0; j < chunk.vertices.size(); ++j)
+            {
+                mStitcher.origins[first + j] = chunk.vertices[j];
+                mStitcher.neighbors[first + j] = chunk.neighbors[j];
+                mStitcher.slotVertices[first + j] = 0;
+            }
+        }
+    }, 1);
+    if (!mStitcher.stitch(mDiagram, mPoints, mSites))
+        return constructWithSweep();
+    return true;
+}
+
+bool CellClippingAlgorithm::computeCell(unsigned int site, ClippedCell& cell) const
+{
+    if (site >= mPoints.size())
+        return false;
+    Vector2 point = mPoints[site];
+    cell.mSite = site;
+    cell.mNearestSites.resize(INITIAL_NEIGHBORS > VERTEX_NEIGHBORS ? INITIAL_NEIGHBORS : VERTEX_NEIGHBORS);
+    cell.mSquaredDistances.resize(cell.mNearestSites.size());
+    cell.mVertices.resize(4);
+    cell.mNeighbors.resize(4);
+    cell.mVertices[0] = Vector2(mBox.left, mBox.bottom);
+    cell.mVertices[1] = Vector2(mBox.right, mBox.bottom);
+    cell.mVertices[2] = Vector2(mBox.right, mBox.top);
+    cell.mVertices[3] = Vector2(mBox.left, mBox.top);
+    for (unsigned int i = 0; i < 4; ++i)
+        cell.mNeighbors[i] = NONE;
+
+    // The nearest sites come by increasing distance, the bisector of a site farther than twice the
+    // radius of the cell is beyond all its vertices
+    double squaredRadius = getSquaredRadius(cell, point);
+    unsigned int nbFound = mTree.getNearestSites(point, INITIAL_NEIGHBORS, cell.mNearestSites.mData, cell.mSquaredDistances.mData);
+    for (unsigned int i = 0; i < nbFound; ++i)
+    {
+        if (cell.mSquaredDistances[i] > 4.0 * squaredRadius)
+            return true;
+        unsigned int neighbor = cell.mNearestSites[i];
+        if (neighbor == site)
+            continue;
+        clip(cell, point, mPoints[neighbor], neighbor);
+        squaredRadius = getSquaredRadius(cell, point);
+    }
+    if (nbFound < INITIAL_NEIGHBORS)
+        return true;
+
+    // Otherwise each vertex is proved by looking for a site closer to it than the site, it has at
+    // most two neighbors of the cell as close. A site that was not clipped is at least as far as the
+    // last one, it can only be closer to the vertices farther than half this distance
+    double lastSquaredDistance = cell.mSquaredDistances[INITIAL_NEIGHBORS - 1];
+    unsigned int i = 0;
+    while (i < cell.mVertices.size())
+    {
+        Vector2 vertex = cell.mVertices[i];
+        double squaredDistance = vertex.getSquaredDistance(point);
+        if (4.0 * squaredDistance <= lastSquaredDistance)
+        {
+            ++i;
+            continue;
+        }
+        double threshold = squaredDistance * (1.0 - CIRCLE_TOLERANCE);
+        nbFound = mTree.getNearestSites(vertex, VERTEX_NEIGHBORS, cell.mNearestSites.mData, cell.mSquaredDistances.mData);
+        unsigned int cutter = NONE;
+        for (unsigned int j = 0; j < nbFound && cell.mSquaredDistances[j] < threshold; ++j)
+        {
+            unsigned int neighbor = cell.mNearestSites[j];
+            if (neighbor != site && !isNeighbor(cell, neighbor))
+            {
+                cutter = neighbor;
+                break;
+            }
+        }
+        if (cutter == NONE)
+            ++i;
+        else
+        {
+            // The vertices of the new cell are checked again
+            clip(cell, point, mPoints[cutter], cutter);
+            i = 0;
+        }
+    }
+    return true;
+}
+
+const VoronoiDiagram& CellClippingAlgorithm::getDiagram() const
+{
+    return mDiagram;
+}
+
+VoronoiDiagram CellClippingAlgorithm::takeDiagram()
+{
+    return static_cast<VoronoiDiagram&&>(mDiagram);
+}
+
+void CellClippingAlgorithm::recycleDiagram(VoronoiDiagram&& diagram)
+{
+    mDiagram = static_cast<VoronoiDiagram&&>(diagram);
+}
+
+bool CellClippingAlgorithm::usedSweep() const
+{
+    return mUsedSweep;
+}
+
+// Cells
+
+// Keeps the part of the cell on the side of the site of the bisector with the neighbor. Each vertex
+// carries the label of the edge that starts there, the edge along the bisector gets the neighbor
+void CellClippingAlgorithm::clip(ClippedCell& cell, const Vector2& site, const Vector2& neighbor, unsigned int label)
+{
+    // A point is kept if (p - middle) . direction <= 0
+    Vector2 middle = 0.5 * (site + neighbor);
+    Vector2 direction = neighbor - site;
+    unsigned int nbVertices = cell.mVertices.size();
+    bool isCut = false;
+    for (unsigned int i = 0; i < nbVertices && !isCut; ++i)
+        isCut = (cell.mVertices[i] - middle).dot(direction) > 0.0;
+    if (!isCut)
+        return;
+
+    cell.mClippedVertices.clear();
+    cell.mClippedNeighbors.clear();
+    double first = (cell.mVertices[0] - middle).dot(direction);
+    double current = first;
+    for (unsigned int i = 0; i < nbVertices; ++i)
+    {
+        const Vector2& vertex = cell.mVertices[i];
+        const Vector2& nextVertex = cell.mVertices[i + 1 < nbVertices ? i + 1 : 0];
+        double next = i + 1 < nbVertices ? (nextVertex - middle).dot(direction) : first;
+        if (current <= 0.0)
+        {
+            // Leaving the half plane, at the vertex itself if it is on the bisector
+            if (next > 0.0 && current == 0.0)
+            {
+                cell.mClippedVertices.push_back(vertex);
+                cell.mClippedNeighbors.push_back(label);
+            }
+            else
+            {
+                cell.mClippedVertices.push_back(vertex);
+                cell.mClippedNeighbors.push_back(cell.mNeighbors[i]);
+                if (next > 0.0)
+                {
+                    cell.mClippedVertices.push_back(vertex + (current / (current - next)) * (nextVertex - vertex));
+                    cell.mClippedNeighbors.push_back(label);
+                }
+            }
+        }
+        else if (next < 0.0)
+        {
+            // Entering the half plane, a vertex on the bisector is added by the next edge
+            cell.mClippedVertices.push_back(vertex + (current / (current - next)) * (nextVertex - vertex));
+            cell.mClippedNeighbors.push_back(cell.mNeighbors[i]);
+        }
+        current = next;
+    }
+    swapValues(cell.mVertices, cell.mClippedVertices);
+    swapValues(cell.mNeighbors, cell.mClippedNeighbors);
+}
+
+double CellClippingAlgorithm::getSquaredRadius(const ClippedCell& cell, const Vector2& site)
+{
+    double squaredRadius = 0.0;
+    for (unsigned int i = 0; i < cell.mVertices.size(); ++i)
+    {
+        double squaredDistance = site.getSquaredDistance(cell.mVertices[i]);
+        squaredRadius = squaredDistance > squaredRadius ? squaredDistance : squaredRadius;
+    }
+    return squaredRadius;
+}
+
+bool CellClippingAlgorithm::isNeighbor(const ClippedCell& cell, unsigned int site)
+{
+    for (unsigned int i = 0; i < cell.mNeighbors.size(); ++i)
+    {
+        if (cell.mNeighbors[i] == site)
+            return true;
+    }
+    return false;
+}
+
+// Stitching
+
+// Sweep, bound on a larger box and intersection
+bool CellClippingAlgorithm::constructWithSweep()
+{
+    mUsedSweep = true;
+    mFallback.reset(mPoints);
+    return mFallback.constructClipped(mBox, mDiagram);
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+// My includes
+#include "FortuneAlgorithm.h"
+#include "CellStitcher.h"
+#include "KdTree.h"
+#include "ParallelFor.h"
+
+// Cell of one site computed by CellClippingAlgorithm, it also holds the scratch of the
+// computation so that a cell reused for many queries does not allocate
+class ClippedCell
+{
+public:
+    // nullptr takes the memory from the default resource
+    explicit ClippedCell(MemoryResource* resource = nullptr);
+
+    // Accessors
+    unsigned int getSite() const;
+    unsigned int getNbVertices() const;
+    // Vertices counterclockwise
+    const Vector2& getVertex(unsigned int i) const;
+    // Site on the other side of the edge from vertex i to vertex i + 1, NONE on the box
+    unsigned int getNeighbor(unsigned int i) const;
+
+private:
+    friend class CellClippingAlgorithm;
+
+    unsigned int mSite;
+    IndexPool<Vector2> mVertices;
+    IndexPool<unsigned int> mNeighbors;
+    // Polygon being clipped and nearest sites found so far
+    IndexPool<Vector2> mClippedVertices;
+    IndexPool<unsigned int> mClippedNeighbors;
+    IndexPool<unsigned int> mNearestSites;
+    IndexPool<double> mSquaredDistances;
+};
+
+// Voronoi diagram clipped to a box built cell by cell. The cell of a site is the box clipped by
+// the bisectors with its nearest sites, found by a k-d tree, until the next site is farther than
+// twice the distance from the site to the farthest vertex of the cell: its bisector can not cut
+// the cell anymore. The cells do not depend on each other so they are computed in parallel, and
+// a single cell can be computed without the others.
+//
+// The cells are then stitched into one diagram by a CellStitcher as the strips of
+// BasicParallelFortuneAlgorithm are, with the box as the other side of the box edges. The result is the one of a sweep followed by
+// bound and intersect on the same box, up to the numbering of the vertices and the half edges.
+// Sites in degenerate positions, e.g. cocircular, may give cells that do not agree on their
+// common vertices because of rounding: then the diagram is built by a sweep.
+//
+// The tree, the stitching, the diagram, the sweep and the array of the threads take their memory
+// from the resource of the algorithm, only from the thread that calls it. The cells computed by a
+// thread take all their memory from the resource of the thread.
+class CellClippingAlgorithm
+{
+public:
+    static constexpr unsigned int NONE = VoronoiDiagram::NONE;
+    // Nearest sites clipped first, most cells are proved by them
+    static constexpr unsigned int INITIAL_NEIGHBORS = 16;
+    // Nearest sites of a vertex looked at to prove it
+    static constexpr unsigned int VERTEX_NEIGHBORS = 4;
+
+    // nbThreads = 0 uses all the hardware threads, they are started once with the algorithm.
+    // threadResources, if not nullptr, holds one resource per thread, getNbThreads(nbThreads) of
+    // them. nullptr takes the memory from the default resource
+    CellClippingAlgorithm(Box box, unsigned int nbThreads = 0, MemoryResource* resource = nullptr,
+        MemoryResource* const* threadResources = nullptr);
+    ~CellClippingAlgorithm();
+
+    // Remove copy operations
+    CellClippingAlgorithm(const CellClippingAlgorithm&) = delete;
+    CellClippingAlgorithm& operator=(const CellClippingAlgorithm&) = delete;
+
+    // Start over with new sites, they must be distinct and inside the box. They are read in place
+    // until the next construct, the k-d tree is built at once
+    void reset(PointSpan points);
+
+    // Builds the whole diagram, returns false if it could not be clipped
+    bool construct();
+    // Computes the cell of one site without building the diagram, returns false if the site is
+    // out of range. Several threads can compute cells at the same time with their own ClippedCell
+    bool computeCell(unsigned int site, ClippedCell& cell) const;
+
+    // Accessors
+    const VoronoiDiagram& getDiagram() const;
+    VoronoiDiagram takeDiagram();
+    void recycleDiagram(VoronoiDiagram&& diagram);
+    // Whether the last construction fell back to a sweep
+    bool usedSweep() const;
+
+private:
+    // Cells of a contiguous range of sites, computed by one thread
+    struct Chunk
+    {
+        explicit Chunk(MemoryResource* resource) : cell(resource), vertices(resource), neighbors(resource)
+        {
+
+        }
+
+        ClippedCell cell;
+        IndexPool<Vector2> vertices;
+        IndexPool<unsigned int> neighbors;
+    };
+
+    Box mBox;
+    ThreadPool mThreadPool;
+    MemoryResource* mResource;
+    PointSpan mPoints;
+    KdTree mTree;
+    VoronoiDiagram mDiagram;
+    FortuneAlgorithm mFallback;
+    bool mUsedSweep;
+    // One chunk per thread, kept with their storage for the next constructions
+    Chunk* mChunks;
+    unsigned int mNbChunks;
+
+    // The cells are numbered in the order of the tree so that close cells are computed together,
+    // mSites gives the site of a cell and mRanks the cell of a site
+    IndexPool<unsigned int> mSites;
+    IndexPool<unsigned int> mRanks;
+
+    // Closed cells
+    CellStitcher mStitcher;
+
+    // Cells
+    static void clip(ClippedCell& cell, const Vector2& site, const Vector2& neighbor, unsigned int label);
+    static double getSquaredRadius(const ClippedCell& cell, const Vector2& site);
+    static bool isNeighbor(const ClippedCell& cell, unsigned int site);
+
+    bool constructWithSweep();
+};
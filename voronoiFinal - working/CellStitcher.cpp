@@ -0,0 +1,208 @@
+#include "CellStitcher.h"
+// STL
+#include <atomic>
+// My includes
+#include "ParallelFor.h"
+
+CellStitcher::CellStitcher(bool hasOpenCells, ThreadPool* threadPool, MemoryResource* resource) :
+    cellOffsets(resource), openCells(resource), neighbors(resource), origins(resource), slotVertices(resource),
+    mHasOpenCells(hasOpenCells), mThreadPool(threadPool), mSlotHalfEdges(resource), mEdgeOffsets(resource),
+    mVertexOffsets(resource)
+{
+
+}
+
+void CellStitcher::resizeCells(unsigned int nbCells)
+{
+    cellOffsets.resize(nbCells + 1);
+    if (mHasOpenCells)
+        openCells.resize(nbCells);
+}
+
+unsigned int CellStitcher::allocateSlots()
+{
+    unsigned int nbCells = cellOffsets.size() - 1;
+    unsigned int nbSlots = 0;
+    for (unsigned int i = 0; i < nbCells; ++i)
+    {
+        unsigned int degree = cellOffsets[i];
+        cellOffsets[i] = nbSlots;
+        nbSlots += degree;
+    }
+    cellOffsets[nbCells] = nbSlots;
+    neighbors.resize(nbSlots);
+    origins.resize(nbSlots);
+    slotVertices.resize(nbSlots);
+    mSlotHalfEdges.resize(nbSlots);
+    return nbSlots;
+}
+
+bool CellStitcher::stitch(VoronoiDiagram& diagram, PointSpan points, const IndexPool<unsigned int>& sites)
+{
+    unsigned int nbCells = cellOffsets.size() - 1;
+    // An edge belongs to its first cell, and so does a vertex, the edges on the box to their only cell
+    mEdgeOffsets.resize(nbCells + 1);
+    mVertexOffsets.resize(nbCells + 1);
+    std::atomic<unsigned int> nbSharedSlots(0);
+    parallelFor(mThreadPool, nbCells, [this, &nbSharedSlots](unsigned int begin, unsigned int end)
+    {
+        unsigned int nbChunkSharedSlots = 0;
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            unsigned int nbEdges = 0;
+            unsigned int nbVertices = 0;
+            for (unsigned int j = cellOffsets[i]; j < cellOffsets[i + 1]; ++j)
+            {
+                if (neighbors[j] > i)
+                    ++nbEdges;
+                if (neighbors[j] != NONE)
+                    ++nbChunkSharedSlots;
+                if (slotVertices[j] != NONE && neighbors[j] > i && neighbors[getPrevSlot(i, j)] > i)
+                    ++nbVertices;
+            }
+            mEdgeOffsets[i] = nbEdges;
+            mVertexOffsets[i] = nbVertices;
+        }
+        nbSharedSlots += nbChunkSharedSlots;
+    });
+    unsigned int nbEdges = 0;
+    unsigned int nbVertices = 0;
+    for (unsigned int i = 0; i < nbCells; ++i)
+    {
+        unsigned int nbCellEdges = mEdgeOffsets[i];
+        unsigned int nbCellVertices = mVertexOffsets[i];
+        mEdgeOffsets[i] = nbEdges;
+        mVertexOffsets[i] = nbVertices;
+        nbEdges += nbCellEdges;
+        nbVertices += nbCellVertices;
+    }
+    // Each edge between two cells is seen by both
+    if (2 * (nbEdges - (cellOffsets[nbCells] - nbSharedSlots)) != nbSharedSlots)
+        return false;
+    diagram.reset(points);
+    diagram.mVertices.resize(nbVertices);
+    diagram.mHalfEdges.resize(2 * nbEdges);
+
+    // The owners number their edges and vertices
+    parallelFor(mThreadPool, nbCells, [this, &diagram](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            unsigned int edge = mEdgeOffsets[i];
+            unsigned int vertex = mVertexOffsets[i];
+            for (unsigned int j = cellOffsets[i]; j < cellOffsets[i + 1]; ++j)
+            {
+                if (neighbors[j] > i)
+                    mSlotHalfEdges[j] = 2 * edge++;
+                if (slotVertices[j] != NONE && neighbors[j] > i && neighbors[getPrevSlot(i, j)] > i)
+                {
+                    slotVertices[j] = vertex;
+                    diagram.mVertices[vertex].point = origins[j];
+                    ++vertex;
+                }
+            }
+        }
+    });
+
+    // The other cells look themselves up in the cell of the owner
+    std::atomic<bool> isConsistent(true);
+    parallelFor(mThreadPool, nbCells, [this, &isConsistent](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            for (unsigned int j = cellOffsets[i]; j < cellOffsets[i + 1]; ++j)
+            {
+                unsigned int neighbor = neighbors[j];
+                if (neighbor < i)
+                {
+                    unsigned int twin = findNeighbor(neighbor, i);
+                    if (twin == NONE)
+                    {
+                        isConsistent = false;
+                        return;
+                    }
+                    mSlotHalfEdges[j] = VoronoiDiagram::getTwin(mSlotHalfEdges[twin]);
+                }
+                if (slotVertices[j] == NONE)
+                    continue;
+                unsigned int prevNeighbor = neighbors[getPrevSlot(i, j)];
+                if (neighbor > i && prevNeighbor > i)
+                    continue;
+                // Around the vertex, the edge of the previous neighbor towards i starts there while
+                // the edge of the next neighbor towards i ends there
+                unsigned int slot = NONE;
+                if (prevNeighbor < neighbor)
+                {
+                    unsigned int twin = findNeighbor(prevNeighbor, i);
+                    unsigned int prev = twin != NONE ? getPrevSlot(prevNeighbor, twin) : NONE;
+                    if (prev != NONE && neighbors[prev] == neighbor)
+                        slot = twin;
+                }
+                else
+                {
+                    unsigned int twin = findNeighbor(neighbor, i);
+                    unsigned int next = twin != NONE ? getNextSlot(neighbor, twin) : NONE;
+                    if (next != NONE && neighbors[next] == prevNeighbor)
+                        slot = next;
+                }
+                if (slot == NONE || slotVertices[slot] == NONE)
+                {
+                    isConsistent = false;
+                    return;
+                }
+                slotVertices[j] = slotVertices[slot];
+            }
+        }
+    });
+    if (!isConsistent)
+        return false;
+
+    // Link the half edges
+    parallelFor(mThreadPool, nbCells, [this, &diagram, &sites](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            if (cellOffsets[i] == cellOffsets[i + 1])
+                continue;
+            unsigned int face = diagram.mSites[sites[i]].face;
+            for (unsigned int j = cellOffsets[i]; j < cellOffsets[i + 1]; ++j)
+            {
+                unsigned int prev = getPrevSlot(i, j);
+                unsigned int next = getNextSlot(i, j);
+                VoronoiDiagram::HalfEdge& halfEdge = diagram.mHalfEdges[mSlotHalfEdges[j]];
+                halfEdge.origin = slotVertices[j];
+                halfEdge.destination = next != NONE ? slotVertices[next] : NONE;
+                halfEdge.incidentFace = face;
+                halfEdge.prev = prev != NONE ? mSlotHalfEdges[prev] : NONE;
+                halfEdge.next = next != NONE ? mSlotHalfEdges[next] : NONE;
+            }
+            diagram.mFaces[face].outerComponent = mSlotHalfEdges[cellOffsets[i]];
+        }
+    });
+    return true;
+}
+
+// The slots of a closed cell wrap around, an open cell starts with the half edge coming from infinity
+unsigned int CellStitcher::getPrevSlot(unsigned int cell, unsigned int slot) const
+{
+    if (slot > cellOffsets[cell])
+        return slot - 1;
+    return mHasOpenCells && openCells[cell] ? NONE : cellOffsets[cell + 1] - 1;
+}
+
+unsigned int CellStitcher::getNextSlot(unsigned int cell, unsigned int slot) const
+{
+    if (slot + 1 < cellOffsets[cell + 1])
+        return slot + 1;
+    return mHasOpenCells && openCells[cell] ? NONE : cellOffsets[cell];
+}
+
+unsigned int CellStitcher::findNeighbor(unsigned int cell, unsigned int neighbor) const
+{
+    for (unsigned int i = cellOffsets[cell]; i < cellOffsets[cell + 1]; ++i)
+    {
+        if (neighbors[i] == neighbor)
+            return i;
+    }
+    return NONE;
+}
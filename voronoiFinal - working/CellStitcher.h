@@ -0,0 +1,58 @@
+#pragma once
+
+// My includes
+#include "VoronoiDiagram.h"
+
+class ThreadPool;
+
+// Joins cells computed separately, e.g. by the strips of BasicParallelFortuneAlgorithm or one by one
+// by CellClippingAlgorithm, into one diagram.
+//
+// The builder first writes the degree of each cell in cellOffsets and calls allocateSlots, then fills
+// the slots: slot j of a cell is its j-th half edge counterclockwise. An edge and a vertex are numbered
+// by their first cell, the other cells find their numbers by looking themselves up in the cell of the
+// owner. Two cells that do not agree on an edge or a vertex make the stitching fail.
+//
+// The slots take their memory from the resource of the stitcher, only from the thread that calls it:
+// the threads of the passes write into arrays sized beforehand.
+class CellStitcher
+{
+public:
+    static constexpr unsigned int NONE = VoronoiDiagram::NONE;
+
+    // With open cells, an unbounded cell starts with the half edge coming from infinity and its
+    // slots do not wrap around, otherwise all the cells are closed. The passes are split over the
+    // threads of the pool of the builder, nullptr runs them on the calling thread alone. nullptr
+    // takes the memory from the default resource
+    CellStitcher(bool hasOpenCells, ThreadPool* threadPool, MemoryResource* resource = nullptr);
+
+    // Sizes the cells, their degrees are then written in cellOffsets
+    void resizeCells(unsigned int nbCells);
+    // Turns the degrees into offsets and sizes the slots, returns their number
+    unsigned int allocateSlots();
+    // Builds the diagram of points, cell i being the cell of sites[i], returns false if two
+    // cells do not agree
+    bool stitch(VoronoiDiagram& diagram, PointSpan points, const IndexPool<unsigned int>& sites);
+
+    // Cells one after the other
+    IndexPool<unsigned int> cellOffsets;
+    // Only with open cells
+    IndexPool<bool> openCells;
+    // Slots
+    // Cells, NONE on the box: NONE is greater than any cell, so a box edge belongs to its cell and
+    // so does a vertex between two box edges
+    IndexPool<unsigned int> neighbors;
+    IndexPool<Vector2> origins;
+    IndexPool<unsigned int> slotVertices; // NONE if the origin is at infinity, any other value otherwise
+
+private:
+    bool mHasOpenCells;
+    ThreadPool* mThreadPool;
+    IndexPool<unsigned int> mSlotHalfEdges;
+    IndexPool<unsigned int> mEdgeOffsets;
+    IndexPool<unsigned int> mVertexOffsets;
+
+    unsigned int getPrevSlot(unsigned int cell, unsigned int slot) const;
+    unsigned int getNextSlot(unsigned int cell, unsigned int slot) const;
+    unsigned int findNeighbor(unsigned int cell, unsigned int neighbor) const;
+};
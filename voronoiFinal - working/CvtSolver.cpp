@@ -0,0 +1,275 @@
+#include "CvtSolver.h"
+// STL
+#include <cmath>
+// My includes
+#include "Swap.h"
+
+static double dot(const IndexPool<double>& a, const IndexPool<double>& b)
+{
+    double sum = 0.0;
+    for (unsigned int i = 0; i < a.size(); ++i)
+        sum += a[i] * b[i];
+    return sum;
+}
+
+template<typename BeachlineType>
+BasicCvtSolver<BeachlineType>::BasicCvtSolver(Box box, unsigned int nbThreads, MemoryResource* resource) :
+    mAlgorithm(resource), mBox(box), mThreadPool(nbThreads, resource), mHasOrder(false), mIsEvaluated(false), mNbConstructions(0),
+    mSites(resource), mGradient(resource), mMasses(resource), mEnergy(0.0), mDiagram(resource),
+    mTrialSites(resource), mTrialGradient(resource), mTrialMasses(resource), mTrialEnergy(0.0), mTrialDiagram(resource),
+    mDirection(resource), mNbPairs(0), mNewestPair(0), mCentroidX(resource), mCentroidY(resource), mEnergies(resource)
+{
+    // A moved pool keeps its resource
+    for (unsigned int i = 0; i < MEMORY; ++i)
+    {
+        mPositionDifferences[i] = IndexPool<double>(resource);
+        mGradientDifferences[i] = IndexPool<double>(resource);
+    }
+}
+
+template<typename BeachlineType>
+void BasicCvtSolver<BeachlineType>::reset(PointSpan points)
+{
+    unsigned int nbSites = points.size();
+    mSites.resize(2 * nbSites);
+    for (unsigned int i = 0; i < nbSites; ++i)
+    {
+        mSites[2 * i] = points.getX(i);
+        mSites[2 * i + 1] = points.getY(i);
+    }
+    mGradient.resize(2 * nbSites);
+    mTrialSites.resize(2 * nbSites);
+    mTrialGradient.resize(2 * nbSites);
+    mDirection.resize(2 * nbSites);
+    for (unsigned int k = 0; k < MEMORY; ++k)
+    {
+        mPositionDifferences[k].resize(2 * nbSites);
+        mGradientDifferences[k].resize(2 * nbSites);
+    }
+    mMasses.resize(nbSites);
+    mTrialMasses.resize(nbSites);
+    mCentroidX.resize(nbSites);
+    mCentroidY.resize(nbSites);
+    mEnergies.resize(nbSites);
+    mHasOrder = false;
+    mIsEvaluated = false;
+    mNbConstructions = 0;
+    mEnergy = 0.0;
+    mNbPairs = 0;
+    mNewestPair = 0;
+}
+
+template<typename BeachlineType>
+bool BasicCvtSolver<BeachlineType>::step()
+{
+    if (!mIsEvaluated)
+    {
+        if (!evaluate(mSites, mGradient, mMasses, mEnergy, mDiagram))
+            return false;
+        mIsEvaluated = true;
+    }
+    computeDirection();
+    // Without enough curvature information the direction may go uphill, start again from a Lloyd step
+    if (!(dot(mGradient, mDirection) < 0.0) && mNbPairs > 0)
+    {
+        mNbPairs = 0;
+        computeDirection();
+    }
+
+    // Backtracking line search, the sites are kept in the box and the decrease is measured
+    // along the step actually taken
+    unsigned int nbSites = mMasses.size();
+    double alpha = 1.0;
+    for (unsigned int i = 0; i < MAX_LINE_SEARCH_STEPS; ++i, alpha *= 0.5)
+    {
+        double slope = 0.0;
+        for (unsigned int j = 0; j < nbSites; ++j)
+        {
+            double x = mSites[2 * j] + alpha * mDirection[2 * j];
+            double y = mSites[2 * j + 1] + alpha * mDirection[2 * j + 1];
+            x = x < mBox.left ? mBox.left : (x > mBox.right ? mBox.right : x);
+            y = y < mBox.bottom ? mBox.bottom : (y > mBox.top ? mBox.top : y);
+            slope += mGradient[2 * j] * (x - mSites[2 * j]) + mGradient[2 * j + 1] * (y - mSites[2 * j + 1]);
+            mTrialSites[2 * j] = x;
+            mTrialSites[2 * j + 1] = y;
+        }
+        if (!(slope < 0.0))
+            break;
+        if (evaluate(mTrialSites, mTrialGradient, mTrialMasses, mTrialEnergy, mTrialDiagram) &&
+            mTrialEnergy <= mEnergy + ARMIJO * slope)
+        {
+            acceptTrial();
+            return true;
+        }
+    }
+    // The curvature information is dropped so that the next step is a Lloyd step
+    mNbPairs = 0;
+    return false;
+}
+
+template<typename BeachlineType>
+unsigned int BasicCvtSolver<BeachlineType>::run(unsigned int maxIterations, double gradientTolerance, double energyTolerance)
+{
+    unsigned int nbIterations = 0;
+    while (nbIterations < maxIterations)
+    {
+        double previousEnergy = mEnergy;
+        bool wasEvaluated = mIsEvaluated;
+        if (!step())
+            break;
+        ++nbIterations;
+        if (getGradientNorm() <= gradientTolerance)
+            break;
+        if (wasEvaluated && previousEnergy - mEnergy <= energyTolerance * previousEnergy)
+            break;
+    }
+    return nbIterations;
+}
+
+template<typename BeachlineType>
+PointSpan BasicCvtSolver<BeachlineType>::getSites() const
+{
+    return PointSpan(mSites.mData, mMasses.size());
+}
+
+template<typename BeachlineType>
+const VoronoiDiagram& BasicCvtSolver<BeachlineType>::getDiagram() const
+{
+    return mDiagram;
+}
+
+template<typename BeachlineType>
+double BasicCvtSolver<BeachlineType>::getEnergy() const
+{
+    return mEnergy;
+}
+
+template<typename BeachlineType>
+double BasicCvtSolver<BeachlineType>::getGradientNorm() const
+{
+    return std::sqrt(dot(mGradient, mGradient));
+}
+
+template<typename BeachlineType>
+unsigned int BasicCvtSolver<BeachlineType>::getNbConstructions() const
+{
+    return mNbConstructions;
+}
+
+// Builds and clips the diagram of the sites, then computes the energy and its gradient
+template<typename BeachlineType>
+bool BasicCvtSolver<BeachlineType>::evaluate(const IndexPool<double>& sites, IndexPool<double>& gradient,
+    IndexPool<double>& masses, double& energy, VoronoiDiagram& diagram)
+{
+    unsigned int nbSites = masses.size();
+    // The sites of two consecutive evaluations are close, the previous order is used to sort them
+    if (mHasOrder)
+        mAlgorithm.moveSites(PointSpan(sites.mData, nbSites));
+    else
+        mAlgorithm.reset(PointSpan(sites.mData, nbSites));
+    mHasOrder = true;
+    ++mNbConstructions;
+    if (!mAlgorithm.constructClipped(mBox, diagram))
+        return false;
+
+    VoronoiDiagram::CellMeasures measures = {mCentroidX.mData, mCentroidY.mData, masses.mData, nullptr, mEnergies.mData};
+    diagram.computeCellMeasures(measures, &mThreadPool);
+    energy = 0.0;
+    for (unsigned int i = 0; i < nbSites; ++i)
+    {
+        // A degenerate cell does not pull its site
+        double mass = masses[i] > 0.0 ? masses[i] : 0.0;
+        gradient[2 * i] = 2.0 * mass * (sites[2 * i] - mCentroidX[i]);
+        gradient[2 * i + 1] = 2.0 * mass * (sites[2 * i + 1] - mCentroidY[i]);
+        energy += mass > 0.0 ? mEnergies[i] : 0.0;
+    }
+    return true;
+}
+
+// Two-loop recursion, the initial inverse Hessian diag(1 / (2 * m_i)) is scaled by the
+// curvature of the newest pair
+template<typename BeachlineType>
+void BasicCvtSolver<BeachlineType>::computeDirection()
+{
+    unsigned int n = mDirection.size();
+    for (unsigned int i = 0; i < n; ++i)
+        mDirection[i] = -mGradient[i];
+    for (unsigned int k = 0; k < mNbPairs; ++k)
+    {
+        unsigned int pair = (mNewestPair + MEMORY - k) % MEMORY;
+        mAlphas[pair] = mRhos[pair] * dot(mPositionDifferences[pair], mDirection);
+        const IndexPool<double>& gradientDifference = mGradientDifferences[pair];
+        for (unsigned int i = 0; i < n; ++i)
+            mDirection[i] -= mAlphas[pair] * gradientDifference[i];
+    }
+    double scale = 1.0;
+    if (mNbPairs > 0)
+    {
+        const IndexPool<double>& gradientDifference = mGradientDifferences[mNewestPair];
+        double weightedNorm = 0.0;
+        for (unsigned int i = 0; i < n; ++i)
+        {
+            double mass = mMasses[i / 2];
+            if (mass > 0.0)
+                weightedNorm += gradientDifference[i] * gradientDifference[i] / (2.0 * mass);
+        }
+        if (weightedNorm > 0.0)
+            scale = 1.0 / (mRhos[mNewestPair] * weightedNorm);
+    }
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        double mass = mMasses[i / 2];
+        mDirection[i] = mass > 0.0 ? scale * mDirection[i] / (2.0 * mass) : 0.0;
+    }
+    for (unsigned int k = mNbPairs; k > 0; --k)
+    {
+        unsigned int pair = (mNewestPair + MEMORY - (k - 1)) % MEMORY;
+        double beta = mRhos[pair] * dot(mGradientDifferences[pair], mDirection);
+        const IndexPool<double>& positionDifference = mPositionDifferences[pair];
+        for (unsigned int i = 0; i < n; ++i)
+            mDirection[i] += (mAlphas[pair] - beta) * positionDifference[i];
+    }
+}
+
+// Stores the differences between the trial and the current point, the pairs without positive
+// curvature are skipped to keep the inverse Hessian positive definite
+template<typename BeachlineType>
+void BasicCvtSolver<BeachlineType>::addPair()
+{
+    unsigned int pair = mNbPairs == 0 ? 0 : (mNewestPair + 1) % MEMORY;
+    IndexPool<double>& positionDifference = mPositionDifferences[pair];
+    IndexPool<double>& gradientDifference = mGradientDifferences[pair];
+    for (unsigned int i = 0; i < positionDifference.size(); ++i)
+    {
+        positionDifference[i] = mTrialSites[i] - mSites[i];
+        gradientDifference[i] = mTrialGradient[i] - mGradient[i];
+    }
+    double curvature = dot(positionDifference, gradientDifference);
+    if (!(curvature > 0.0))
+    {
+        // The slot held the oldest pair
+        if (mNbPairs == MEMORY)
+            --mNbPairs;
+        return;
+    }
+    mRhos[pair] = 1.0 / curvature;
+    mNewestPair = pair;
+    if (mNbPairs < MEMORY)
+        ++mNbPairs;
+}
+
+template<typename BeachlineType>
+void BasicCvtSolver<BeachlineType>::acceptTrial()
+{
+    addPair();
+    swapValues(mSites, mTrialSites);
+    swapValues(mGradient, mTrialGradient);
+    swapValues(mMasses, mTrialMasses);
+    swapValues(mEnergy, mTrialEnergy);
+    swapValues(mDiagram, mTrialDiagram);
+}
+
+// Instantiations for the available beachlines
+template class BasicCvtSolver<Beachline>;
+template class BasicCvtSolver<FlatBeachline>;
+template class BasicCvtSolver<BTreeBeachline>;
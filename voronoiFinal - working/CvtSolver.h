@@ -0,0 +1,88 @@
+#pragma once
+
+// My includes
+#include "FortuneAlgorithm.h"
+#include "ParallelFor.h"
+
+// Centroidal Voronoi tessellation by minimizing the energy E = sum of the integrals of the
+// squared distance to the site over the clipped cells. Its gradient with respect to the site i
+// is 2 * m_i * (x_i - c_i) where m_i is the area and c_i the centroid of the cell, so each
+// evaluation of E is one construction. The minimization is L-BFGS whose initial inverse Hessian
+// is diag(1 / (2 * m_i)): the first step is exactly a Lloyd step and the next ones use the
+// curvature seen by the previous steps. All the storage of the solver is taken from its resource,
+// only from the thread that calls it, the threads of the cells are started once with the solver.
+template<typename BeachlineType = Beachline>
+class BasicCvtSolver
+{
+public:
+    // Number of position and gradient differences kept for the inverse Hessian
+    static constexpr unsigned int MEMORY = 7;
+    // Halvings of the step before the line search gives up
+    static constexpr unsigned int MAX_LINE_SEARCH_STEPS = 10;
+    // Sufficient decrease of the energy required by the line search
+    static constexpr double ARMIJO = 1e-4;
+
+    // The sites must be inside the box, nbThreads = 0 uses all the hardware threads for the cells,
+    // nullptr takes the memory from the default resource
+    BasicCvtSolver(Box box, unsigned int nbThreads = 0, MemoryResource* resource = nullptr);
+
+    // Start over with new sites, they are copied
+    void reset(PointSpan points);
+
+    // One iteration, returns false if no step decreased the energy or the diagram could not be
+    // clipped, then the sites do not move
+    bool step();
+    // Iterate until the norm of the gradient is at most gradientTolerance or the energy decreased
+    // by less than energyTolerance relatively, returns the number of iterations done
+    unsigned int run(unsigned int maxIterations, double gradientTolerance, double energyTolerance);
+
+    // Accessors
+    PointSpan getSites() const;
+    // Clipped diagram of the current sites, valid after the first step
+    const VoronoiDiagram& getDiagram() const;
+    double getEnergy() const;
+    double getGradientNorm() const;
+    // Number of diagrams built since the last reset, the line search may build several per step
+    unsigned int getNbConstructions() const;
+
+private:
+    BasicFortuneAlgorithm<BeachlineType> mAlgorithm;
+    Box mBox;
+    ThreadPool mThreadPool;
+    bool mHasOrder;
+    bool mIsEvaluated;
+    unsigned int mNbConstructions;
+    // Current point: interleaved sites, gradient, cell areas, energy and diagram
+    IndexPool<double> mSites;
+    IndexPool<double> mGradient;
+    IndexPool<double> mMasses;
+    double mEnergy;
+    VoronoiDiagram mDiagram;
+    // Point tried by the line search, swapped with the current one when it is accepted
+    IndexPool<double> mTrialSites;
+    IndexPool<double> mTrialGradient;
+    IndexPool<double> mTrialMasses;
+    double mTrialEnergy;
+    VoronoiDiagram mTrialDiagram;
+    // Search direction
+    IndexPool<double> mDirection;
+    // Last differences of positions and gradients, mNewestPair is the last one written
+    IndexPool<double> mPositionDifferences[MEMORY];
+    IndexPool<double> mGradientDifferences[MEMORY];
+    double mRhos[MEMORY];
+    double mAlphas[MEMORY];
+    unsigned int mNbPairs;
+    unsigned int mNewestPair;
+    // Scratch for the cell measures
+    IndexPool<double> mCentroidX;
+    IndexPool<double> mCentroidY;
+    IndexPool<double> mEnergies;
+
+    bool evaluate(const IndexPool<double>& sites, IndexPool<double>& gradient, IndexPool<double>& masses,
+        double& energy, VoronoiDiagram& diagram);
+    void computeDirection();
+    void addPair();
+    void acceptTrial();
+};
+
+using CvtSolver = BasicCvtSolver<Beachline>;
@@ -1,5 +1,7 @@
 #pragma once
 
+// STL
+#include <cmath>
 // My includes
 #include "Vector2.h"
 #include "VoronoiDiagram.h"
@@ -9,29 +11,54 @@ struct Arc;
 class Event
 {
 public:
-    enum class Type{SITE, CIRCLE};
-
-	// Used in eventVector
-	Event *next;
-
 	Event();
-    // Site event
-    Event(VoronoiDiagram::Site* site);
-    // Circle event
+    // Circle event, site events are not queued
     Event(double y, Vector2 point, Arc* arc);
 
-    Type type;
     double y;
     int index;
-    // Site event
-    VoronoiDiagram::Site* site;
-    // Circle event
+    union
+    {
+        Arc* arc;
+        // Used in EventPool
+        Event* nextFree;
+    };
+    // Convergence point
     Vector2 point;
-    Arc* arc;
-
-	void operator=(const Event& rhs);
-
 };
 
 bool operator<(const Event& lhs, const Event& rhs);
 
+// Circle event of the arcs of the foci point1, point2 and point3 from left to right when the sweep
+// line is at beachlineY, shared by the sweeps. Returns false if their breakpoints do not move toward
+// the convergence point, otherwise writes it in point and the height of the event in y.
+inline bool computeCircleEvent(const Vector2& point1, const Vector2& point2, const Vector2& point3, double beachlineY,
+    Vector2& point, double& y)
+{
+    Vector2 v1 = (point1 - point2).getOrthogonal();
+    Vector2 v2 = (point2 - point3).getOrthogonal();
+    Vector2 delta = 0.5 * (point3 - point1);
+    double t = delta.getDet(v2) / v1.getDet(v2);
+    point = 0.5 * (point1 + point2) + t * v1;
+    // A breakpoint moves right when its left focus is the lower one, it starts from the higher one
+    bool leftBreakpointMovingRight = point1.y < point2.y;
+    bool rightBreakpointMovingRight = point2.y < point3.y;
+    double leftInitialX = leftBreakpointMovingRight ? point1.x : point2.x;
+    double rightInitialX = rightBreakpointMovingRight ? point2.x : point3.x;
+    bool isValid =
+        ((leftBreakpointMovingRight && leftInitialX < point.x) ||
+        (!leftBreakpointMovingRight && leftInitialX > point.x)) &&
+        ((rightBreakpointMovingRight && rightInitialX < point.x) ||
+        (!rightBreakpointMovingRight && rightInitialX > point.x));
+    if (!isValid)
+        return false;
+    // The breakpoints converge so the event can not be above the beachline. When a site falls
+    // almost under a breakpoint, the arc it leaves between them is squeezed right away and the
+    // rounded event may land slightly above: it is clamped instead of being dropped, otherwise
+    // the empty arc would stay in the beachline and hide its neighbors from later sites.
+    y = point.y - std::sqrt(point.getSquaredDistance(point1));
+    if (y > beachlineY)
+        y = beachlineY;
+    return true;
+}
+
@@ -0,0 +1,631 @@
+#pragma once
+
+// My includes
+#include "BeachlineBase.h"
+#include "Event.h"
+#include "Box.h"
+#include "PointSpan.h"
+
+// Fortune's algorithm for at most N sites with all its storage sized at compile time: nothing is
+// allocated, the object can be static or a member of another object. It is meant for small
+// diagrams built again and again, e.g. the layout of a few sensors on an embedded target, where
+// the pools, the beachline tree and the queue of FortuneAlgorithm cost more than the geometry.
+//
+// The sweep is the one of FortuneAlgorithm with a flat beachline: the arcs are kept in x order in
+// an array, located by binary search on the breakpoints and shifted on insertion and removal, which
+// is cheap for a few hundred arcs. An arc has at most one circle event so the events are stored in
+// the arcs and the heap only holds arc indices. The diagram keeps its edges with the two sites they
+// separate instead of half edges, and the cell of a site is the box clipped by the bisectors with
+// its neighbors as in CellClippingAlgorithm.
+//
+// The object takes about 480 * N bytes, 120 KB for 256 sites: it should not be put on a small stack.
+template<unsigned int N>
+class FixedFortuneAlgorithm
+{
+    static_assert(N > 0, "FixedFortuneAlgorithm needs room for one site");
+
+public:
+    static constexpr unsigned int NONE = 0xFFFFFFFF;
+    // Bounds of a diagram of N sites given by Euler's formula, reached when the hull is a triangle
+    static constexpr unsigned int MAX_VERTICES = N >= 3 ? 2 * N - 5 : 0;
+    static constexpr unsigned int MAX_EDGES = N >= 3 ? 3 * N - 6 : N - 1;
+    // A cell clipped to the box has at most four vertices more than neighbors
+    static constexpr unsigned int MAX_CELL_VERTICES = 4 * N + 2 * MAX_EDGES;
+
+    struct Edge
+    {
+        // Sites on the left and on the right of the edge looking down the sweep when it appeared
+        unsigned int sites[2];
+        // Ends of the edge, NONE for an end at infinity
+        unsigned int vertices[2];
+    };
+
+    constexpr FixedFortuneAlgorithm(Box box) : mBox(box)
+    {
+
+    }
+
+    // Builds the diagram of the points and clips its cells to the box, the sites must be distinct.
+    // Returns false if there are more than N points or if rounding gave more vertices than a
+    // diagram of N sites can have, then the cells are empty
+    bool construct(PointSpan points);
+
+    // Accessors
+
+    constexpr unsigned int getNbSites() const
+    {
+        return mNbSites;
+    }
+
+    constexpr const Vector2& getSite(unsigned int i) const
+    {
+        return mSites[i];
+    }
+
+    constexpr unsigned int getNbVertices() const
+    {
+        return mNbVertices;
+    }
+
+    constexpr const Vector2& getVertex(unsigned int i) const
+    {
+        return mVertices[i];
+    }
+
+    constexpr unsigned int getNbEdges() const
+    {
+        return mNbEdges;
+    }
+
+    constexpr const Edge& getEdge(unsigned int i) const
+    {
+        return mEdges[i];
+    }
+
+    // Cells clipped to the box, their vertices are counterclockwise
+
+    constexpr unsigned int getNbCellVertices(unsigned int site) const
+    {
+        return mCellOffsets[site + 1] - mCellOffsets[site];
+    }
+
+    constexpr const Vector2* getCellVertices(unsigned int site) const
+    {
+        return mCellVertices + mCellOffsets[site];
+    }
+
+    // Site on the other side of the edge from vertex i to vertex i + 1, NONE on the box
+    constexpr const unsigned int* getCellNeighbors(unsigned int site) const
+    {
+        return mCellNeighbors + mCellOffsets[site];
+    }
+
+private:
+    // Every site but the first one splits an arc in three
+    static constexpr unsigned int MAX_ARCS = 2 * N - 1;
+    // No array may be empty
+    static constexpr unsigned int VERTEX_CAPACITY = MAX_VERTICES > 0 ? MAX_VERTICES : 1;
+    static constexpr unsigned int EDGE_CAPACITY = MAX_EDGES > 0 ? MAX_EDGES : 1;
+
+    struct Arc
+    {
+        unsigned int site = 0;
+        unsigned int rightEdge = NONE; // Edge traced by the right breakpoint
+        unsigned int position = 0; // In the beachline
+        unsigned int event = NONE; // In the heap
+        double eventY = 0.0;
+        Vector2 eventPoint;
+    };
+
+    Box mBox;
+    double mBeachlineY = 0.0;
+    // Diagram
+    unsigned int mNbSites = 0;
+    unsigned int mNbVertices = 0;
+    unsigned int mNbEdges = 0;
+    Vector2 mSites[N];
+    Vector2 mVertices[VERTEX_CAPACITY];
+    Edge mEdges[EDGE_CAPACITY] = {};
+    // Sweep
+    unsigned int mOrder[N] = {}; // Sites by decreasing y then increasing x
+    unsigned int mNbArcs = 0;
+    unsigned int mBeachlineSize = 0;
+    unsigned int mNbEvents = 0;
+    Arc mArcs[MAX_ARCS];
+    unsigned int mBeachline[MAX_ARCS] = {};
+    unsigned int mEvents[MAX_ARCS] = {}; // Max-heap on Arc::eventY
+    // Cells, the edges of site i are mSiteEdges[mEdgeOffsets[i]] to mSiteEdges[mEdgeOffsets[i + 1] - 1]
+    unsigned int mEdgeOffsets[N + 1] = {};
+    unsigned int mSiteEdges[2 * EDGE_CAPACITY] = {};
+    bool mInsideVertices[VERTEX_CAPACITY] = {};
+    // Ends of the edges of the cell being closed
+    unsigned int mEdgeStarts[N] = {};
+    unsigned int mEdgeEnds[N] = {};
+    unsigned int mCellOffsets[N + 1] = {};
+    Vector2 mCellVertices[MAX_CELL_VERTICES];
+    unsigned int mCellNeighbors[MAX_CELL_VERTICES] = {};
+    // Polygons being clipped
+    unsigned int mPolygonSizes[2] = {};
+    Vector2 mPolygonVertices[2][N + 4];
+    unsigned int mPolygonNeighbors[2][N + 4] = {};
+
+    // Algorithm
+    void sortSites();
+    void handleSiteEvent(unsigned int site);
+    bool handleCircleEvent(unsigned int arc);
+    unsigned int locateArcAbove(const Vector2& point) const;
+
+    // Arcs
+    unsigned int createArc(unsigned int site, unsigned int rightEdge);
+    void insertArc(unsigned int position, unsigned int arc);
+    void removeArc(unsigned int position);
+
+    // Edges
+    unsigned int createEdge(unsigned int leftSite, unsigned int rightSite);
+    void setEnd(unsigned int edge, unsigned int leftSite, unsigned int vertex);
+
+    // Events
+    void addEvent(unsigned int left, unsigned int middle, unsigned int right);
+    void deleteEvent(unsigned int arc);
+    void siftUp(unsigned int i);
+    void siftDown(unsigned int i);
+
+    // Cells
+    void clipCells();
+    bool closeCell(unsigned int site, bool& isInside);
+    bool clip(unsigned int polygon, const Vector2& middle, const Vector2& direction, unsigned int label);
+    void clearCells();
+
+    constexpr unsigned int getNeighbor(unsigned int edge, unsigned int site) const
+    {
+        return mEdges[edge].sites[0] == site ? mEdges[edge].sites[1] : mEdges[edge].sites[0];
+    }
+};
+
+template<unsigned int N>
+bool FixedFortuneAlgorithm<N>::construct(PointSpan points)
+{
+    mNbSites = 0;
+    mNbVertices = 0;
+    mNbEdges = 0;
+    mNbArcs = 0;
+    mBeachlineSize = 0;
+    mNbEvents = 0;
+    if (points.size() > N)
+    {
+        clearCells();
+        return false;
+    }
+    mNbSites = points.size();
+    for (unsigned int i = 0; i < mNbSites; ++i)
+        mSites[i] = points[i];
+    sortSites();
+
+    // Process events, take the highest of the next site and the next circle event
+    unsigned int nextSite = 0;
+    while (nextSite < mNbSites || mNbEvents > 0)
+    {
+        if (nextSite < mNbSites && (mNbEvents == 0 || mSites[mOrder[nextSite]].y >= mArcs[mEvents[0]].eventY))
+        {
+            mBeachlineY = mSites[mOrder[nextSite]].y;
+            handleSiteEvent(mOrder[nextSite]);
+            ++nextSite;
+        }
+        else
+        {
+            unsigned int arc = mEvents[0];
+            mBeachlineY = mArcs[arc].eventY;
+            deleteEvent(arc);
+            if (!handleCircleEvent(arc))
+            {
+                clearCells();
+                return false;
+            }
+        }
+    }
+    clipCells();
+    return true;
+}
+
+// Algorithm
+
+// Insertion sort by decreasing y then increasing x
+template<unsigned int N>
+void FixedFortuneAlgorithm<N>::sortSites()
+{
+    for (unsigned int i = 0; i < mNbSites; ++i)
+    {
+        const Vector2& point = mSites[i];
+        unsigned int j = i;
+        while (j > 0 && (mSites[mOrder[j - 1]].y < point.y || (mSites[mOrder[j - 1]].y == point.y && mSites[mOrder[j - 1]].x > point.x)))
+        {
+            mOrder[j] = mOrder[j - 1];
+            --j;
+        }
+        mOrder[j] = i;
+    }
+}
+
+template<unsigned int N>
+void FixedFortuneAlgorithm<N>::handleSiteEvent(unsigned int site)
+{
+    // 1. Check if the beachline is empty
+    if (mBeachlineSize == 0)
+    {
+        insertArc(0, createArc(site, NONE));
+        return;
+    }
+    // 2. Look for the arc above the site
+    unsigned int position = locateArcAbove(mSites[site]);
+    unsigned int arc = mBeachline[position];
+    // The arcs of the sites on the first line are vertical half lines, they are put side by side
+    if (mSites[mArcs[arc].site].y == mSites[site].y)
+    {
+        unsigned int edge = createEdge(mArcs[arc].site, site);
+        unsigned int rightArc = createArc(site, mArcs[arc].rightEdge);
+        mArcs[arc].rightEdge = edge;
+        insertArc(position + 1, rightArc);
+        return;
+    }
+    deleteEvent(arc);
+    // 3. Split the arc around the new one, its left part keeps its index
+    unsigned int edge = createEdge(mArcs[arc].site, site);
+    unsigned int middleArc = createArc(site, edge);
+    unsigned int rightArc = createArc(mArcs[arc].site, mArcs[arc].rightEdge);
+    mArcs[arc].rightEdge = edge;
+    insertArc(position + 1, middleArc);
+    insertArc(position + 2, rightArc);
+    // 4. Check circle events
+    if (position > 0)
+        addEvent(mBeachline[position - 1], arc, middleArc);
+    if (position + 3 < mBeachlineSize)
+        addEvent(middleArc, rightArc, mBeachline[position + 3]);
+}
+
+template<unsigned int N>
+bool FixedFortuneAlgorithm<N>::handleCircleEvent(unsigned int arc)
+{
+    if (mNbVertices == MAX_VERTICES)
+        return false;
+    // 1. Add vertex
+    unsigned int vertex = mNbVertices++;
+    mVertices[vertex] = mArcs[arc].eventPoint;
+    // 2. Delete all the events with this arc
+    unsigned int position = mArcs[arc].position;
+    unsigned int leftArc = mBeachline[position - 1];
+    unsigned int rightArc = mBeachline[position + 1];
+    deleteEvent(leftArc);
+    deleteEvent(rightArc);
+    // 3. End the edges of both breakpoints and start the one of the new breakpoint
+    setEnd(mArcs[leftArc].rightEdge, mArcs[leftArc].site, vertex);
+    setEnd(mArcs[arc].rightEdge, mArcs[arc].site, vertex);
+    removeArc(position);
+    // The edges grow by one per site and one per vertex so they can not overflow before the vertices
+    unsigned int edge = createEdge(mArcs[leftArc].site, mArcs[rightArc].site);
+    mEdges[edge].vertices[0] = vertex;
+    mArcs[leftArc].rightEdge = edge;
+    // 4. Add new circle events
+    position = position - 1;
+    if (position > 0)
+        addEvent(mBeachline[position - 1], leftArc, rightArc);
+    if (position + 2 < mBeachlineSize)
+        addEvent(leftArc, rightArc, mBeachline[position + 2]);
+    return true;
+}
+
+// Last arc whose left breakpoint is not on the right of point
+template<unsigned int N>
+unsigned int FixedFortuneAlgorithm<N>::locateArcAbove(const Vector2& point) const
+{
+    unsigned int first = 0;
+    unsigned int last = mBeachlineSize - 1;
+    while (first < last)
+    {
+        unsigned int middle = (first + last + 1) / 2;
+        const Vector2& left = mSites[mArcs[mBeachline[middle - 1]].site];
+        const Vector2& right = mSites[mArcs[mBeachline[middle]].site];
+        if (BeachlineBase::compareToBreakpoint(point.x, left.x, left.y, right.x, right.y, mBeachlineY) >= 0)
+            first = middle;
+        else
+            last = middle - 1;
+    }
+    return first;
+}
+
+// Arcs
+
+template<unsigned int N>
+unsigned int FixedFortuneAlgorithm<N>::createArc(unsigned int site, unsigned int rightEdge)
+{
+    Arc& arc = mArcs[mNbArcs];
+    arc.site = site;
+    arc.rightEdge = rightEdge;
+    arc.event = NONE;
+    return mNbArcs++;
+}
+
+template<unsigned int N>
+void FixedFortuneAlgorithm<N>::insertArc(unsigned int position, unsigned int arc)
+{
+    for (unsigned int i = mBeachlineSize; i > position; --i)
+    {
+        mBeachline[i] = mBeachline[i - 1];
+        mArcs[mBeachline[i]].position = i;
+    }
+    mBeachline[position] = arc;
+    mArcs[arc].position = position;
+    ++mBeachlineSize;
+}
+
+template<unsigned int N>
+void FixedFortuneAlgorithm<N>::removeArc(unsigned int position)
+{
+    --mBeachlineSize;
+    for (unsigned int i = position; i < mBeachlineSize; ++i)
+    {
+        mBeachline[i] = mBeachline[i + 1];
+        mArcs[mBeachline[i]].position = i;
+    }
+}
+
+// Edges
+
+template<unsigned int N>
+unsigned int FixedFortuneAlgorithm<N>::createEdge(unsigned int leftSite, unsigned int rightSite)
+{
+    mEdges[mNbEdges] = Edge{{leftSite, rightSite}, {NONE, NONE}};
+    return mNbEdges++;
+}
+
+// An edge that appeared at a site event is traced by two breakpoints, the one with its left site
+// on the left ends vertices[0]. An edge that appeared at a vertex starts there and ends vertices[1]
+template<unsigned int N>
+void FixedFortuneAlgorithm<N>::setEnd(unsigned int edge, unsigned int leftSite, unsigned int vertex)
+{
+    Edge& e = mEdges[edge];
+    e.vertices[e.vertices[0] == NONE && e.sites[0] == leftSite ? 0 : 1] = vertex;
+}
+
+// Events
+
+template<unsigned int N>
+void FixedFortuneAlgorithm<N>::addEvent(unsigned int left, unsigned int middle, unsigned int right)
+{
+    Vector2 center;
+    double y;
+    if (!computeCircleEvent(mSites[mArcs[left].site], mSites[mArcs[middle].site], mSites[mArcs[right].site], mBeachlineY, center, y))
+        return;
+    Arc& arc = mArcs[middle];
+    arc.eventY = y;
+    arc.eventPoint = center;
+    arc.event = mNbEvents;
+    mEvents[mNbEvents++] = middle;
+    siftUp(arc.event);
+}
+
+template<unsigned int N>
+void FixedFortuneAlgorithm<N>::deleteEvent(unsigned int arc)
+{
+    unsigned int i = mArcs[arc].event;
+    if (i == NONE)
+        return;
+    mArcs[arc].event = NONE;
+    --mNbEvents;
+    if (i < mNbEvents)
+    {
+        mEvents[i] = mEvents[mNbEvents];
+        mArcs[mEvents[i]].event = i;
+        if (i > 0 && mArcs[mEvents[(i - 1) / 2]].eventY < mArcs[mEvents[i]].eventY)
+            siftUp(i);
+        else
+            siftDown(i);
+    }
+}
+
+template<unsigned int N>
+void FixedFortuneAlgorithm<N>::siftUp(unsigned int i)
+{
+    unsigned int arc = mEvents[i];
+    double y = mArcs[arc].eventY;
+    while (i > 0 && mArcs[mEvents[(i - 1) / 2]].eventY < y)
+    {
+        mEvents[i] = mEvents[(i - 1) / 2];
+        mArcs[mEvents[i]].event = i;
+        i = (i - 1) / 2;
+    }
+    mEvents[i] = arc;
+    mArcs[arc].event = i;
+}
+
+template<unsigned int N>
+void FixedFortuneAlgorithm<N>::siftDown(unsigned int i)
+{
+    unsigned int arc = mEvents[i];
+    double y = mArcs[arc].eventY;
+    while (2 * i + 1 < mNbEvents)
+    {
+        unsigned int child = 2 * i + 1;
+        if (child + 1 < mNbEvents && mArcs[mEvents[child + 1]].eventY > mArcs[mEvents[child]].eventY)
+            ++child;
+        if (mArcs[mEvents[child]].eventY <= y)
+            break;
+        mEvents[i] = mEvents[child];
+        mArcs[mEvents[i]].event = i;
+        i = child;
+    }
+    mEvents[i] = arc;
+    mArcs[arc].event = i;
+}
+
+// Cells
+
+template<unsigned int N>
+void FixedFortuneAlgorithm<N>::clipCells()
+{
+    // Edges of the sites by counting sort
+    for (unsigned int i = 0; i <= mNbSites; ++i)
+        mEdgeOffsets[i] = 0;
+    for (unsigned int i = 0; i < mNbEdges; ++i)
+    {
+        ++mEdgeOffsets[mEdges[i].sites[0] + 1];
+        ++mEdgeOffsets[mEdges[i].sites[1] + 1];
+    }
+    for (unsigned int i = 0; i < mNbSites; ++i)
+        mEdgeOffsets[i + 1] += mEdgeOffsets[i];
+    for (unsigned int i = 0; i < mNbEdges; ++i)
+    {
+        mSiteEdges[mEdgeOffsets[mEdges[i].sites[0]]++] = i;
+        mSiteEdges[mEdgeOffsets[mEdges[i].sites[1]]++] = i;
+    }
+    // Each offset moved to the next one, move them back
+    for (unsigned int i = mNbSites; i > 0; --i)
+        mEdgeOffsets[i] = mEdgeOffsets[i - 1];
+    mEdgeOffsets[0] = 0;
+    for (unsigned int i = 0; i < mNbVertices; ++i)
+        mInsideVertices[i] = mBox.contains(mVertices[i]);
+
+    // Most cells are closed and inside the box, the others are clipped
+    mCellOffsets[0] = 0;
+    for (unsigned int i = 0; i < mNbSites; ++i)
+    {
+        unsigned int polygon = 0;
+        bool isInside = true;
+        if (closeCell(i, isInside))
+        {
+            if (!isInside)
+            {
+                const Vector2 corner1(mBox.left, mBox.bottom);
+                const Vector2 corner2(mBox.right, mBox.top);
+                if (clip(polygon, corner1, Vector2(-1.0, 0.0), NONE))
+                    polygon = 1 - polygon;
+                if (clip(polygon, corner1, Vector2(0.0, -1.0), NONE))
+                    polygon = 1 - polygon;
+                if (clip(polygon, corner2, Vector2(1.0, 0.0), NONE))
+                    polygon = 1 - polygon;
+                if (clip(polygon, corner2, Vector2(0.0, 1.0), NONE))
+                    polygon = 1 - polygon;
+            }
+        }
+        else
+        {
+            mPolygonVertices[0][0] = Vector2(mBox.left, mBox.bottom);
+            mPolygonVertices[0][1] = Vector2(mBox.right, mBox.bottom);
+            mPolygonVertices[0][2] = Vector2(mBox.right, mBox.top);
+            mPolygonVertices[0][3] = Vector2(mBox.left, mBox.top);
+            for (unsigned int j = 0; j < 4; ++j)
+                mPolygonNeighbors[0][j] = NONE;
+            mPolygonSizes[0] = 4;
+            for (unsigned int j = mEdgeOffsets[i]; j < mEdgeOffsets[i + 1]; ++j)
+            {
+                unsigned int neighbor = getNeighbor(mSiteEdges[j], i);
+                if (clip(polygon, 0.5 * (mSites[i] + mSites[neighbor]), mSites[neighbor] - mSites[i], neighbor))
+                    polygon = 1 - polygon;
+            }
+        }
+        unsigned int first = mCellOffsets[i];
+        for (unsigned int j = 0; j < mPolygonSizes[polygon]; ++j)
+        {
+            mCellVertices[first + j] = mPolygonVertices[polygon][j];
+            mCellNeighbors[first + j] = mPolygonNeighbors[polygon][j];
+        }
+        mCellOffsets[i + 1] = first + mPolygonSizes[polygon];
+    }
+}
+
+// Chains the edges of a cell counterclockwise in the first polygon, each one starts at the vertex
+// that comes first when turning counterclockwise around the site. Returns false if the cell is not
+// closed: an edge is infinite, or it has edges of length zero whose ends can not be ordered
+template<unsigned int N>
+bool FixedFortuneAlgorithm<N>::closeCell(unsigned int site, bool& isInside)
+{
+    const Vector2& point = mSites[site];
+    unsigned int first = mEdgeOffsets[site];
+    unsigned int nbEdges = mEdgeOffsets[site + 1] - first;
+    for (unsigned int i = 0; i < nbEdges; ++i)
+    {
+        const Edge& edge = mEdges[mSiteEdges[first + i]];
+        if (edge.vertices[0] == NONE || edge.vertices[1] == NONE)
+            return false;
+        isInside = isInside && mInsideVertices[edge.vertices[0]] && mInsideVertices[edge.vertices[1]];
+        Vector2 tangent = (mSites[getNeighbor(mSiteEdges[first + i], site)] - point).getOrthogonal();
+        bool isForward = mVertices[edge.vertices[0]].dot(tangent) < mVertices[edge.vertices[1]].dot(tangent);
+        mEdgeStarts[i] = edge.vertices[isForward ? 0 : 1];
+        mEdgeEnds[i] = edge.vertices[isForward ? 1 : 0];
+    }
+    unsigned int current = 0;
+    for (unsigned int i = 0; i < nbEdges; ++i)
+    {
+        mPolygonVertices[0][i] = mVertices[mEdgeStarts[current]];
+        mPolygonNeighbors[0][i] = getNeighbor(mSiteEdges[first + current], site);
+        unsigned int next = 0;
+        while (next < nbEdges && mEdgeStarts[next] != mEdgeEnds[current])
+            ++next;
+        // The chain must come back to the first edge after the last one only
+        if (next == nbEdges || (next == 0) != (i + 1 == nbEdges))
+            return false;
+        current = next;
+    }
+    mPolygonSizes[0] = nbEdges;
+    return nbEdges >= 3;
+}
+
+// Clipping of CellClippingAlgorithm: keeps the part of the polygon behind the line through middle
+// orthogonal to direction in the other polygon, the edge along the line gets the label. Returns
+// false if nothing is cut
+template<unsigned int N>
+bool FixedFortuneAlgorithm<N>::clip(unsigned int polygon, const Vector2& middle, const Vector2& direction, unsigned int label)
+{
+    const Vector2* vertices = mPolygonVertices[polygon];
+    const unsigned int* neighbors = mPolygonNeighbors[polygon];
+    Vector2* clippedVertices = mPolygonVertices[1 - polygon];
+    unsigned int* clippedNeighbors = mPolygonNeighbors[1 - polygon];
+    unsigned int& nbClippedVertices = mPolygonSizes[1 - polygon];
+    // A point is kept if (p - middle) . direction <= 0
+    unsigned int nbVertices = mPolygonSizes[polygon];
+    bool isCut = false;
+    for (unsigned int i = 0; i < nbVertices && !isCut; ++i)
+        isCut = (vertices[i] - middle).dot(direction) > 0.0;
+    if (!isCut)
+        return false;
+
+    nbClippedVertices = 0;
+    double first = (vertices[0] - middle).dot(direction);
+    double current = first;
+    for (unsigned int i = 0; i < nbVertices; ++i)
+    {
+        const Vector2& vertex = vertices[i];
+        const Vector2& nextVertex = vertices[i + 1 < nbVertices ? i + 1 : 0];
+        double next = i + 1 < nbVertices ? (nextVertex - middle).dot(direction) : first;
+        if (current <= 0.0)
+        {
+            // Leaving the half plane, at the vertex itself if it is on the bisector
+            clippedVertices[nbClippedVertices] = vertex;
+            if (next > 0.0 && current == 0.0)
+                clippedNeighbors[nbClippedVertices++] = label;
+            else
+            {
+                clippedNeighbors[nbClippedVertices++] = neighbors[i];
+                if (next > 0.0)
+                {
+                    clippedVertices[nbClippedVertices] = vertex + (current / (current - next)) * (nextVertex - vertex);
+                    clippedNeighbors[nbClippedVertices++] = label;
+                }
+            }
+        }
+        else if (next < 0.0)
+        {
+            // Entering the half plane, a vertex on the bisector is added by the next edge
+            clippedVertices[nbClippedVertices] = vertex + (current / (current - next)) * (nextVertex - vertex);
+            clippedNeighbors[nbClippedVertices++] = neighbors[i];
+        }
+        current = next;
+    }
+    return true;
+}
+
+template<unsigned int N>
+void FixedFortuneAlgorithm<N>::clearCells()
+{
+    for (unsigned int i = 0; i <= mNbSites; ++i)
+        mCellOffsets[i] = 0;
+}
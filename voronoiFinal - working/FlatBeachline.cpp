@@ -0,0 +1,193 @@
+#include "FlatBeachline.h"
+#include "Arc.h"
+
+FlatBeachline::FlatBeachline(MemoryResource* resource) : BeachlineBase(resource),
+    mResource(resource != nullptr ? resource : getDefaultMemoryResource()), mArcs(nullptr), mFocusX(nullptr), mFocusY(nullptr), mCapacity(0), mGapBegin(0), mGapEnd(0)
+{
+
+}
+
+FlatBeachline::~FlatBeachline()
+{
+    destroyArray(mResource, mArcs, mCapacity);
+    destroyArray(mResource, mFocusX, mCapacity);
+    destroyArray(mResource, mFocusY, mCapacity);
+}
+
+void FlatBeachline::clear()
+{
+    mGapBegin = 0;
+    mGapEnd = mCapacity;
+    clearArcs();
+}
+
+bool FlatBeachline::isEmpty() const
+{
+    return getSize() == 0;
+}
+
+void FlatBeachline::setRoot(Arc* x)
+{
+    insert(0, x);
+}
+
+Arc* FlatBeachline::getLeftmostArc() const
+{
+    return isEmpty() ? mNil : mArcs[getSlot(0)];
+}
+
+Arc* FlatBeachline::locateArcAbove(const Vector2& point, double l)
+{
+    // Try the finger first
+    Arc* arc = walkFromFinger(point.x, l);
+    if (arc != nullptr)
+        return arc;
+    // Otherwise look for the last arc whose left breakpoint is not on the right of point
+    unsigned int first = 0;
+    unsigned int last = getSize() - 1;
+    while (first < last)
+    {
+        unsigned int middle = (first + last + 1) / 2;
+        unsigned int left = getSlot(middle - 1);
+        unsigned int right = getSlot(middle);
+        if (compareToBreakpoint(point.x, mFocusX[left], mFocusY[left], mFocusX[right], mFocusY[right], l) >= 0)
+            first = middle;
+        else
+            last = middle - 1;
+    }
+    arc = mArcs[getSlot(first)];
+    setFinger(arc);
+    return arc;
+}
+
+void FlatBeachline::insertBefore(Arc* x, Arc* y)
+{
+    insert(getIndex(x), y);
+    // Set the pointers
+    y->prev = x->prev;
+    if (!isNil(y->prev))
+        y->prev->next = y;
+    y->next = x;
+    x->prev = y;
+}
+
+void FlatBeachline::insertAfter(Arc* x, Arc* y)
+{
+    insert(getIndex(x) + 1, y);
+    // Set the pointers
+    y->next = x->next;
+    if (!isNil(y->next))
+        y->next->prev = y;
+    y->prev = x;
+    x->next = y;
+}
+
+void FlatBeachline::replace(Arc* x, Arc* y)
+{
+    unsigned int slot = x->position;
+    mArcs[slot] = y;
+    mFocusX[slot] = y->focusX;
+    mFocusY[slot] = y->focusY;
+    y->position = slot;
+    // Set the pointers
+    y->prev = x->prev;
+    y->next = x->next;
+    if (!isNil(y->prev))
+        y->prev->next = y;
+    if (!isNil(y->next))
+        y->next->prev = y;
+    moveFinger(x, y);
+}
+
+void FlatBeachline::remove(Arc* z)
+{
+    // The arc is the first slot after the gap once the gap is moved in front of it
+    moveGap(getIndex(z));
+    ++mGapEnd;
+    // Update next and prev
+    if (!isNil(z->prev))
+        z->prev->next = z->next;
+    if (!isNil(z->next))
+        z->next->prev = z->prev;
+    moveFinger(z, isNil(z->prev) ? z->next : z->prev);
+}
+
+unsigned int FlatBeachline::getSize() const
+{
+    return mCapacity - (mGapEnd - mGapBegin);
+}
+
+unsigned int FlatBeachline::getSlot(unsigned int i) const
+{
+    return i < mGapBegin ? i : i + (mGapEnd - mGapBegin);
+}
+
+unsigned int FlatBeachline::getIndex(const Arc* x) const
+{
+    return x->position < mGapBegin ? x->position : x->position - (mGapEnd - mGapBegin);
+}
+
+void FlatBeachline::insert(unsigned int i, Arc* y)
+{
+    if (mGapBegin == mGapEnd)
+        grow();
+    moveGap(i);
+    unsigned int slot = mGapBegin++;
+    mArcs[slot] = y;
+    mFocusX[slot] = y->focusX;
+    mFocusY[slot] = y->focusY;
+    y->position = slot;
+}
+
+// Move the gap so that it begins at index i
+void FlatBeachline::moveGap(unsigned int i)
+{
+    while (mGapBegin > i)
+    {
+        --mGapBegin;
+        --mGapEnd;
+        moveSlot(mGapBegin, mGapEnd);
+    }
+    while (mGapBegin < i)
+    {
+        moveSlot(mGapEnd, mGapBegin);
+        ++mGapBegin;
+        ++mGapEnd;
+    }
+}
+
+void FlatBeachline::moveSlot(unsigned int from, unsigned int to)
+{
+    mArcs[to] = mArcs[from];
+    mFocusX[to] = mFocusX[from];
+    mFocusY[to] = mFocusY[from];
+    mArcs[to]->position = to;
+}
+
+void FlatBeachline::grow()
+{
+    // The capacity doubles, the arcs after the gap move to the end of the new arrays
+    unsigned int capacity = mCapacity == 0 ? MIN_CAPACITY : 2 * mCapacity;
+    Arc** arcs = createArray<Arc*>(mResource, capacity);
+    double* focusX = createArray<double>(mResource, capacity);
+    double* focusY = createArray<double>(mResource, capacity);
+    unsigned int shift = capacity - mCapacity;
+    for (unsigned int slot = 0; slot < mCapacity; ++slot)
+    {
+        unsigned int newSlot = slot < mGapBegin ? slot : slot + shift;
+        if (slot >= mGapBegin && slot < mGapEnd)
+            continue;
+        arcs[newSlot] = mArcs[slot];
+        focusX[newSlot] = mFocusX[slot];
+        focusY[newSlot] = mFocusY[slot];
+        arcs[newSlot]->position = newSlot;
+    }
+    destroyArray(mResource, mArcs, mCapacity);
+    destroyArray(mResource, mFocusX, mCapacity);
+    destroyArray(mResource, mFocusY, mCapacity);
+    mArcs = arcs;
+    mFocusX = focusX;
+    mFocusY = focusY;
+    mCapacity = capacity;
+    mGapEnd += shift;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+// My includes
+#include "Vector2.h"
+#include "VoronoiDiagram.h"
+#include "BeachlineBase.h"
+
+struct Arc;
+
+// Arcs kept in order in an array with a gap where the last update happened.
+// Locating an arc is a binary search on the foci stored next to the arcs and consecutive
+// updates are close to each other so moving the gap is cheap. Suited to small beachlines.
+class FlatBeachline : public BeachlineBase
+{
+public:
+    explicit FlatBeachline(MemoryResource* resource = nullptr);
+    ~FlatBeachline();
+
+    // Remove all the arcs but keep their storage
+    void clear();
+
+    bool isEmpty() const;
+    void setRoot(Arc* x);
+    Arc* getLeftmostArc() const;
+
+    Arc* locateArcAbove(const Vector2& point, double l);
+    void insertBefore(Arc* x, Arc* y);
+    void insertAfter(Arc* x, Arc* y);
+    void replace(Arc* x, Arc* y);
+    void remove(Arc* z);
+
+private:
+    static constexpr unsigned int MIN_CAPACITY = 64;
+
+    // Slot i holds mArcs[i] and its focus (mFocusX[i], mFocusY[i]), Arc::position is the slot of the arc.
+    // The slots in [mGapBegin, mGapEnd) are free.
+    MemoryResource* mResource;
+    Arc** mArcs;
+    double* mFocusX;
+    double* mFocusY;
+    unsigned int mCapacity;
+    unsigned int mGapBegin;
+    unsigned int mGapEnd;
+
+    // Indices are the positions of the arcs in the beachline, slots their positions in the arrays
+    unsigned int getSize() const;
+    unsigned int getSlot(unsigned int i) const;
+    unsigned int getIndex(const Arc* x) const;
+
+    void insert(unsigned int i, Arc* y);
+    void moveGap(unsigned int i);
+    void moveSlot(unsigned int from, unsigned int to);
+    void grow();
+};
@@ -1,48 +1,159 @@
 #include "FortuneAlgorithm.h"
+// STL
+#include <cstring>
 // My includes
 #include "Arc.h"
 #include "Event.h"
 
+template<typename T>
+static void reverse(T* first, T* last)
+{
+    for (; first + 1 < last; ++first)
+    {
+        --last;
+        T tmp = *first;
+        *first = *last;
+        *last = tmp;
+    }
+}
+
+template<typename BeachlineType>
+BasicFortuneAlgorithm<BeachlineType>::BasicFortuneAlgorithm(MemoryResource* resource) :
+    mDiagram(resource), mBeachline(resource), mEventPool(resource), mEvents(resource), mBeachlineY(0.0),
+    mSiteKeys(resource), mSiteKeysBuffer(resource)
+{
+
+}
 
-FortuneAlgorithm::FortuneAlgorithm(Vector2Vector points) : mDiagram(points)
+template<typename BeachlineType>
+BasicFortuneAlgorithm<BeachlineType>::BasicFortuneAlgorithm(const Vector2Vector& points, MemoryResource* resource) :
+    BasicFortuneAlgorithm(resource)
 {
+    mDiagram.reset(points);
+}
+
+template<typename BeachlineType>
+BasicFortuneAlgorithm<BeachlineType>::BasicFortuneAlgorithm(PointSpan points, MemoryResource* resource) :
+    BasicFortuneAlgorithm(resource)
+{
+    mDiagram.reset(points);
+}
+
+template<typename BeachlineType>
+BasicFortuneAlgorithm<BeachlineType>::~BasicFortuneAlgorithm() = default;
+
+template<typename BeachlineType>
+void BasicFortuneAlgorithm<BeachlineType>::reset(const Vector2Vector& points)
+{
+    mDiagram.reset(points);
+    clear();
+}
+
+template<typename BeachlineType>
+void BasicFortuneAlgorithm<BeachlineType>::reset(PointSpan points)
+{
+    mDiagram.reset(points);
+    clear();
+}
 
+template<typename BeachlineType>
+void BasicFortuneAlgorithm<BeachlineType>::moveSites(PointSpan points)
+{
+    mDiagram.reset(points);
+    clear();
+    mReuseSiteOrder = true;
 }
 
-FortuneAlgorithm::~FortuneAlgorithm() = default;
+template<typename BeachlineType>
+void BasicFortuneAlgorithm<BeachlineType>::clear()
+{
+    mReuseSiteOrder = false;
+    mBeachline.clear();
+    mFirstLineArc = nullptr;
+    mEventPool.clear();
+    mEvents.clear();
+    mBeachlineY = 0.0;
+}
 
-void FortuneAlgorithm::construct()
+template<typename BeachlineType>
+void BasicFortuneAlgorithm<BeachlineType>::construct()
 {
-    // Initialize event queue
-    for (unsigned int i = 0; i < mDiagram.getNbSites(); ++i)
-        mEvents.push(new Event(mDiagram.getSite(i)));
+    // Sort the sites once, they are consumed with a cursor
+    sortSites();
+    unsigned int nbSites = mDiagram.getNbSites();
+    unsigned int nextSite = 0;
 
-    // Process events
-    while (!mEvents.isEmpty())
+    // Process events, take the highest of the next site and the next circle event
+    while (nextSite < nbSites || !mEvents.isEmpty())
     {
-        Event *event = mEvents.pop();
-        mBeachlineY = event->y;
-        if(event->type == Event::Type::SITE)
-            handleSiteEvent(event);
+        VoronoiDiagram::Site* site = nextSite < nbSites ? mDiagram.getSite(mSiteKeys[nextSite].index) : nullptr;
+        if (site != nullptr && (mEvents.isEmpty() || site->point.y >= mEvents.top()->y))
+        {
+            mBeachlineY = site->point.y;
+            handleSiteEvent(site);
+            ++nextSite;
+        }
         else
+        {
+            Event *event = mEvents.pop();
+            mBeachlineY = event->y;
             handleCircleEvent(event);
+            mEventPool.release(event);
+        }
     }
 }
 
-VoronoiDiagram FortuneAlgorithm::getDiagram()
+template<typename BeachlineType>
+const VoronoiDiagram& BasicFortuneAlgorithm<BeachlineType>::getDiagram() const
 {
     return mDiagram;
 }
 
-void FortuneAlgorithm::handleSiteEvent(Event* event)
+template<typename BeachlineType>
+VoronoiDiagram BasicFortuneAlgorithm<BeachlineType>::takeDiagram()
+{
+    return static_cast<VoronoiDiagram&&>(mDiagram);
+}
+
+template<typename BeachlineType>
+bool BasicFortuneAlgorithm<BeachlineType>::constructClipped(Box box, VoronoiDiagram& diagram)
+{
+    construct();
+    double margin = BOUNDING_MARGIN * (box.right - box.left + box.top - box.bottom);
+    bool isBounded = bound(Box{box.left - margin, box.bottom - margin, box.right + margin, box.top + margin});
+    // Swap the diagrams so that the next reset reuses the storage of the previous one
+    VoronoiDiagram previousDiagram = static_cast<VoronoiDiagram&&>(diagram);
+    diagram = static_cast<VoronoiDiagram&&>(mDiagram);
+    mDiagram = static_cast<VoronoiDiagram&&>(previousDiagram);
+    return isBounded && diagram.intersect(box);
+}
+
+template<typename BeachlineType>
+void BasicFortuneAlgorithm<BeachlineType>::recycleDiagram(VoronoiDiagram&& diagram)
+{
+    mDiagram = static_cast<VoronoiDiagram&&>(diagram);
+}
+
+template<typename BeachlineType>
+void BasicFortuneAlgorithm<BeachlineType>::handleSiteEvent(VoronoiDiagram::Site* site)
 {
-    VoronoiDiagram::Site* site = event->site;
     // 1. Check if the bachline is empty
     if (mBeachline.isEmpty())
     {
-        mBeachline.setRoot(mBeachline.createArc(site));
+        mFirstLineArc = mBeachline.createArc(site);
+        mBeachline.setRoot(mFirstLineArc);
         return;
     }
+    // The arcs of the sites on the first line are vertical half lines that can not be broken
+    if (mFirstLineArc != nullptr)
+    {
+        if (mFirstLineArc->focusY == site->point.y)
+        {
+            insertArcBeside(site);
+            return;
+        }
+        mFirstLineArc = nullptr;
+    }
     // 2. Look for the arc above the site
     Arc* arcToBreak = mBeachline.locateArcAbove(site->point, mBeachlineY);
     deleteEvent(arcToBreak);
@@ -63,12 +174,49 @@ void FortuneAlgorithm::handleSiteEvent(Event* event)
         addEvent(middleArc, rightArc, rightArc->next);
 }
 
-void FortuneAlgorithm::handleCircleEvent(Event* event)
+// The arcs of the first line are side by side in the order of their sites, the breakpoints can not
+// be located while their parabolas are flat so the place of the new arc is found by walking from
+// the last inserted one, which is next to it when the sites come in order. There is no circle
+// event between aligned sites.
+template<typename BeachlineType>
+void BasicFortuneAlgorithm<BeachlineType>::insertArcBeside(VoronoiDiagram::Site* site)
+{
+    Arc* arc = mFirstLineArc;
+    while (arc->focusX < site->point.x && !mBeachline.isNil(arc->next))
+        arc = arc->next;
+    while (arc->focusX > site->point.x && !mBeachline.isNil(arc->prev))
+        arc = arc->prev;
+    Arc* newArc = mBeachline.createArc(site);
+    mFirstLineArc = newArc;
+    if (arc->focusX > site->point.x)
+    {
+        mBeachline.insertBefore(arc, newArc);
+        addEdge(newArc, arc);
+        return;
+    }
+    Arc* rightArc = arc->next;
+    mBeachline.insertAfter(arc, newArc);
+    // Between two arcs, the edge that separated them now separates the left one from the new one
+    // and the right one takes the half edge of the new edge
+    if (!mBeachline.isNil(rightArc))
+    {
+        newArc->leftHalfEdge = rightArc->leftHalfEdge;
+        mDiagram.getHalfEdge(newArc->leftHalfEdge)->incidentFace = site->face;
+        mDiagram.getFace(site->face)->outerComponent = newArc->leftHalfEdge;
+        addEdge(newArc, rightArc);
+        mDiagram.getFace(rightArc->site->face)->outerComponent = rightArc->leftHalfEdge;
+    }
+    else
+        addEdge(arc, newArc);
+}
+
+template<typename BeachlineType>
+void BasicFortuneAlgorithm<BeachlineType>::handleCircleEvent(Event* event)
 {
     Vector2 point = event->point;
     Arc* arc = event->arc;
     // 1. Add vertex
-    VoronoiDiagram::Vertex* vertex = mDiagram.createVertex(point);
+    unsigned int vertex = mDiagram.createVertex(point);
     // 2. Delete all the events with this arc
     Arc* leftArc = arc->prev;
     Arc* rightArc = arc->next;
@@ -85,7 +233,120 @@ void FortuneAlgorithm::handleCircleEvent(Event* event)
         addEvent(leftArc, rightArc, rightArc->next);
 }
 
-Arc* FortuneAlgorithm::breakArc(Arc* arc, VoronoiDiagram::Site* site)
+template<typename BeachlineType>
+void BasicFortuneAlgorithm<BeachlineType>::sortSites()
+{
+    unsigned int nbSites = mDiagram.getNbSites();
+    if (mReuseSiteOrder && mSiteKeys.size() == nbSites && sortFromPreviousOrder())
+        return;
+    mSiteKeys.resize(nbSites);
+    bool decreasing = true;
+    bool increasing = true;
+    for (unsigned int i = 0; i < nbSites; ++i)
+    {
+        mSiteKeys[i] = SiteKey{getSortKey(mDiagram.getSite(i)->point.y), i};
+        if (i > 0)
+        {
+            decreasing = decreasing && mSiteKeys[i].key >= mSiteKeys[i - 1].key;
+            increasing = increasing && mSiteKeys[i].key <= mSiteKeys[i - 1].key;
+        }
+    }
+    // Already sorted inputs are used as is
+    if (decreasing)
+        return;
+    // Inputs sorted the other way are reversed, then the runs of equal keys are reversed back so
+    // that the ties stay in the order of the indices as with the sorts below
+    if (increasing)
+    {
+        reverse(&mSiteKeys[0], &mSiteKeys[0] + nbSites);
+        for (unsigned int begin = 0, end = 1; begin < nbSites; begin = end++)
+        {
+            while (end < nbSites && mSiteKeys[end].key == mSiteKeys[begin].key)
+                ++end;
+            reverse(&mSiteKeys[0] + begin, &mSiteKeys[0] + end);
+        }
+        return;
+    }
+    // A few sites are cheaper to sort by insertion than to count, it is stable too
+    if (nbSites <= MAX_INSERTION_SORT_SITES)
+    {
+        for (unsigned int i = 1; i < nbSites; ++i)
+        {
+            SiteKey siteKey = mSiteKeys[i];
+            unsigned int j = i;
+            while (j > 0 && mSiteKeys[j - 1].key > siteKey.key)
+            {
+                mSiteKeys[j] = mSiteKeys[j - 1];
+                --j;
+            }
+            mSiteKeys[j] = siteKey;
+        }
+        return;
+    }
+    // LSD radix sort on bytes, the passes where all the keys share the same byte are skipped
+    mSiteKeysBuffer.resize(nbSites);
+    SiteKey* src = &mSiteKeys[0];
+    SiteKey* dst = &mSiteKeysBuffer[0];
+    for (unsigned int shift = 0; shift < 64; shift += 8)
+    {
+        unsigned int count[257] = {0};
+        for (unsigned int i = 0; i < nbSites; ++i)
+            ++count[((src[i].key >> shift) & 0xFF) + 1];
+        if (count[((src[0].key >> shift) & 0xFF) + 1] == nbSites)
+            continue;
+        for (unsigned int digit = 0; digit < 256; ++digit)
+            count[digit + 1] += count[digit];
+        for (unsigned int i = 0; i < nbSites; ++i)
+            dst[count[(src[i].key >> shift) & 0xFF]++] = src[i];
+        SiteKey* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+    if (src != &mSiteKeys[0])
+        std::memcpy(&mSiteKeys[0], src, nbSites * sizeof(SiteKey));
+}
+
+// Insertion sort starting from the order of the last construction, it is linear when the sites
+// barely moved. The ties are broken by index so that the order is the same as the radix sort.
+template<typename BeachlineType>
+bool BasicFortuneAlgorithm<BeachlineType>::sortFromPreviousOrder()
+{
+    unsigned int nbSites = mSiteKeys.size();
+    for (unsigned int i = 0; i < nbSites; ++i)
+        mSiteKeys[i].key = getSortKey(mDiagram.getSite(mSiteKeys[i].index)->point.y);
+    unsigned long long nbShifts = 0;
+    unsigned long long maxShifts = static_cast<unsigned long long>(MAX_SHIFTS_PER_SITE) * nbSites;
+    for (unsigned int i = 1; i < nbSites; ++i)
+    {
+        SiteKey siteKey = mSiteKeys[i];
+        unsigned int j = i;
+        while (j > 0 && (mSiteKeys[j - 1].key > siteKey.key ||
+            (mSiteKeys[j - 1].key == siteKey.key && mSiteKeys[j - 1].index > siteKey.index)))
+        {
+            mSiteKeys[j] = mSiteKeys[j - 1];
+            --j;
+            ++nbShifts;
+        }
+        mSiteKeys[j] = siteKey;
+        if (nbShifts > maxShifts)
+            return false;
+    }
+    return true;
+}
+
+template<typename BeachlineType>
+unsigned long long BasicFortuneAlgorithm<BeachlineType>::getSortKey(double y)
+{
+    unsigned long long bits;
+    std::memcpy(&bits, &y, sizeof(bits));
+    // Make the unsigned order match the order of the doubles
+    bits = (bits & 0x8000000000000000ULL) ? ~bits : bits | 0x8000000000000000ULL;
+    // Then reverse it to get the decreasing order
+    return ~bits;
+}
+
+template<typename BeachlineType>
+Arc* BasicFortuneAlgorithm<BeachlineType>::breakArc(Arc* arc, VoronoiDiagram::Site* site)
 {
     // Create the new subtree
     Arc* middleArc = mBeachline.createArc(site);
@@ -98,396 +359,92 @@ Arc* FortuneAlgorithm::breakArc(Arc* arc, VoronoiDiagram::Site* site)
     mBeachline.insertBefore(middleArc, leftArc);
     mBeachline.insertAfter(middleArc, rightArc);
     // Delete old arc
-    delete arc;
+    mBeachline.deleteArc(arc);
     // Return the middle arc
     return middleArc;
 }
 
-void FortuneAlgorithm::removeArc(Arc* arc, VoronoiDiagram::Vertex* vertex)
+template<typename BeachlineType>
+void BasicFortuneAlgorithm<BeachlineType>::removeArc(Arc* arc, unsigned int vertex)
 {
     // End edges
     setDestination(arc->prev, arc, vertex);
     setDestination(arc, arc->next, vertex);
     // Join the edges of the middle arc
-    arc->leftHalfEdge->next = arc->rightHalfEdge;
-    arc->rightHalfEdge->prev = arc->leftHalfEdge;
+    setPrevHalfEdge(arc->leftHalfEdge, arc->rightHalfEdge);
     // Update beachline
     mBeachline.remove(arc);
     // Create a new edge
-    VoronoiDiagram::HalfEdge* prevHalfEdge = arc->prev->rightHalfEdge;
-    VoronoiDiagram::HalfEdge* nextHalfEdge = arc->next->leftHalfEdge;
+    unsigned int prevHalfEdge = arc->prev->rightHalfEdge;
+    unsigned int nextHalfEdge = arc->next->leftHalfEdge;
     addEdge(arc->prev, arc->next);
     setOrigin(arc->prev, arc->next, vertex);
     setPrevHalfEdge(arc->prev->rightHalfEdge, prevHalfEdge);
     setPrevHalfEdge(nextHalfEdge, arc->next->leftHalfEdge);
     // Delete node
-    delete arc;
-}
-
-bool FortuneAlgorithm::isMovingRight(const Arc* left, const Arc* right) const
-{
-    return left->site->point.y < right->site->point.y;
+    mBeachline.deleteArc(arc);
 }
 
-double FortuneAlgorithm::getInitialX(const Arc* left, const Arc* right, bool movingRight) const
+template<typename BeachlineType>
+void BasicFortuneAlgorithm<BeachlineType>::addEdge(Arc* left, Arc* right)
 {
-    return movingRight ? left->site->point.x : right->site->point.x;
+    // Create two new twin half edges
+    left->rightHalfEdge = mDiagram.createEdge(left->site->face, right->site->face);
+    right->leftHalfEdge = VoronoiDiagram::getTwin(left->rightHalfEdge);
 }
 
-void FortuneAlgorithm::addEdge(Arc* left, Arc* right)
+template<typename BeachlineType>
+void BasicFortuneAlgorithm<BeachlineType>::setOrigin(Arc* left, Arc* right, unsigned int vertex)
 {
-    // Create two new half edges
-    left->rightHalfEdge = mDiagram.createHalfEdge(left->site->face);
-    right->leftHalfEdge = mDiagram.createHalfEdge(right->site->face);
-    // Set the two half edges twins
-    left->rightHalfEdge->twin = right->leftHalfEdge;
-    right->leftHalfEdge->twin = left->rightHalfEdge;
+    mDiagram.getHalfEdge(left->rightHalfEdge)->destination = vertex;
+    mDiagram.getHalfEdge(right->leftHalfEdge)->origin = vertex;
 }
 
-void FortuneAlgorithm::setOrigin(Arc* left, Arc* right, VoronoiDiagram::Vertex* vertex)
+template<typename BeachlineType>
+void BasicFortuneAlgorithm<BeachlineType>::setDestination(Arc* left, Arc* right, unsigned int vertex)
 {
-    left->rightHalfEdge->destination = vertex;
-    right->leftHalfEdge->origin = vertex;
+    mDiagram.getHalfEdge(left->rightHalfEdge)->origin = vertex;
+    mDiagram.getHalfEdge(right->leftHalfEdge)->destination = vertex;
 }
 
-void FortuneAlgorithm::setDestination(Arc* left, Arc* right, VoronoiDiagram::Vertex* vertex)
+template<typename BeachlineType>
+void BasicFortuneAlgorithm<BeachlineType>::setPrevHalfEdge(unsigned int prev, unsigned int next)
 {
-    left->rightHalfEdge->origin = vertex;
-    right->leftHalfEdge->destination = vertex;
+    mDiagram.getHalfEdge(prev)->next = next;
+    mDiagram.getHalfEdge(next)->prev = prev;
 }
 
-void FortuneAlgorithm::setPrevHalfEdge(VoronoiDiagram::HalfEdge* prev, VoronoiDiagram::HalfEdge* next)
-{
-    prev->next = next;
-    next->prev = prev;
-}
-
-void FortuneAlgorithm::addEvent(Arc* left, Arc* middle, Arc* right)
+template<typename BeachlineType>
+void BasicFortuneAlgorithm<BeachlineType>::addEvent(Arc* left, Arc* middle, Arc* right)
 {
+    Vector2 convergencePoint;
     double y;
-    Vector2 convergencePoint = computeConvergencePoint(left->site->point, middle->site->point, right->site->point, y);
-    bool isBelow = y <= mBeachlineY;
-    bool leftBreakpointMovingRight = isMovingRight(left, middle);
-    bool rightBreakpointMovingRight = isMovingRight(middle, right);
-    double leftInitialX = getInitialX(left, middle, leftBreakpointMovingRight);
-    double rightInitialX = getInitialX(middle, right, rightBreakpointMovingRight);
-    bool isValid =
-        ((leftBreakpointMovingRight && leftInitialX < convergencePoint.x) ||
-        (!leftBreakpointMovingRight && leftInitialX > convergencePoint.x)) &&
-        ((rightBreakpointMovingRight && rightInitialX < convergencePoint.x) ||
-        (!rightBreakpointMovingRight && rightInitialX > convergencePoint.x));
-    if (isValid && isBelow)
-    {
-        Event *event = new Event(y, convergencePoint, middle);
-		middle->event = event;
-        mEvents.push(event);
-    }
+    if (!computeCircleEvent(left->site->point, middle->site->point, right->site->point, mBeachlineY, convergencePoint, y))
+        return;
+    Event *event = mEventPool.create(y, convergencePoint, middle);
+	middle->event = event;
+    mEvents.push(event);
 }
 
-void FortuneAlgorithm::deleteEvent(Arc* arc)
+template<typename BeachlineType>
+void BasicFortuneAlgorithm<BeachlineType>::deleteEvent(Arc* arc)
 {
     if (arc->event != nullptr)
     {
         mEvents.remove(arc->event->index);
+        mEventPool.release(arc->event);
         arc->event = nullptr;
     }
 }
 
-Vector2 FortuneAlgorithm::computeConvergencePoint(const Vector2& point1, const Vector2& point2, const Vector2& point3, double& y) const
-{
-    Vector2 v1 = (point1 - point2).getOrthogonal();
-    Vector2 v2 = (point2 - point3).getOrthogonal();
-    Vector2 delta = 0.5 * (point3 - point1);
-    double t = delta.getDet(v2) / v1.getDet(v2);
-    Vector2 center = 0.5 * (point1 + point2) + t * v1;
-    double r = center.getDistance(point1);
-    y = center.y - r;
-    return center;
-}
-
 // Bound
-bool FortuneAlgorithm::bound(Box box)
+template<typename BeachlineType>
+bool BasicFortuneAlgorithm<BeachlineType>::bound(Box box)
 {
-    // Make sure the bounding box contains all the vertices
-	VoronoiDiagram::VertexList myVertices = mDiagram.getVertices();
-	for(unsigned int i = 0; i < myVertices.mSize; i++)
-    {
-		VoronoiDiagram::Vertex* vertex = myVertices.get(i);
-        box.left = min(vertex->point.x, box.left);
-        box.bottom = min(vertex->point.y, box.bottom);
-        box.right = max(vertex->point.x, box.right);
-        box.top = max(vertex->point.y, box.top);
-    }
-    // Retrieve all non bounded half edges from the beach line
-    LinkedVertexList linkedVertices;
-    UnorderedMapLVA vertices;
-    if (!mBeachline.isEmpty())
-    {
-        Arc* leftArc = mBeachline.getLeftmostArc();
-        Arc* rightArc = leftArc->next;
-        while (!mBeachline.isNil(rightArc))
-        {
-            // Bound the edge
-            Vector2 direction = (leftArc->site->point - rightArc->site->point).getOrthogonal();
-            Vector2 origin = (leftArc->site->point + rightArc->site->point) * 0.5f;
-            // Line-box intersection
-            Box::Intersection intersection = box.getFirstIntersection(origin, direction);
-            // Create a new vertex and ends the half edges
-            VoronoiDiagram::Vertex* vertex = mDiagram.createVertex(intersection.point);
-            setDestination(leftArc, rightArc, vertex);
-            // Initialize pointers
-            if (vertices.find(leftArc->site->index) == false) 
-                vertices.initialize(leftArc->site->index);
-            if (vertices.find(rightArc->site->index) == false) 
-                vertices.initialize(rightArc->site->index); 
-            // Store the vertex on the boundaries
-            linkedVertices.emplace_back(new LinkedVertex{nullptr, vertex, leftArc->rightHalfEdge});
-			vertices[leftArc->site->index]->get(2 * static_cast<int>(intersection.side) + 1) = linkedVertices.back();
-			vertices[leftArc->site->index]->get(2 * static_cast<int>(intersection.side) + 1)->setData(&*linkedVertices.back());
-            linkedVertices.emplace_back(new LinkedVertex{rightArc->leftHalfEdge, vertex, nullptr});
-            vertices[rightArc->site->index]->get(2 * static_cast<int>(intersection.side)) = linkedVertices.back();
-			vertices[rightArc->site->index]->get(2 * static_cast<int>(intersection.side))->setData(&*linkedVertices.back());
-            // Next edge
-            leftArc = rightArc;
-            rightArc = rightArc->next;
-        }
-    }
-    // Add corners
-    for (int j = 0; j < vertices.mSize; j++)
-    {
-		LinkedVertexArray* cellVertices = vertices.get(j);
-        // We check twice the first side to be sure that all necessary corners are added
-        for (unsigned int i = 0; i < 5; ++i)
-        {
-            unsigned int side = i % 4;
-            unsigned int nextSide = (side + 1) % 4;
-            // Add first corner
-            if (cellVertices->find(2 * side) == false && cellVertices->find(2 * side + 1) == true)
-            {
-                unsigned int prevSide = (side + 3) % 4;
-                VoronoiDiagram::Vertex* corner = mDiagram.createCorner(box, static_cast<Box::Side>(side));
-                linkedVertices.emplace_back(new LinkedVertex{nullptr, corner, nullptr});
-                cellVertices->get(2 * prevSide + 1) = linkedVertices.back();
-				cellVertices->get(2 * prevSide + 1)->setData(&*linkedVertices.back());
-                cellVertices->get(2 * side) = linkedVertices.back();
-				cellVertices->get(2 * side)->setData(&*linkedVertices.back());
-            }
-            // Add second corner
-            else if (cellVertices->find(2 * side) == true && cellVertices->find(2 * side + 1) == false)
-            {
-                VoronoiDiagram::Vertex* corner = mDiagram.createCorner(box, static_cast<Box::Side>(nextSide));
-                linkedVertices.emplace_back(new LinkedVertex{nullptr, corner, nullptr});
-                cellVertices->get(2 * side + 1) = linkedVertices.back();
-				cellVertices->get(2 * side + 1)->setData(&*linkedVertices.back());
-                cellVertices->get(2 * nextSide) = linkedVertices.back();
-				cellVertices->get(2 * nextSide)->setData(&*linkedVertices.back());
-            }
-        }
-    }
-
-    // Join the half edges
-    for (int i = 0; i < vertices.mSize; i++)
-    {
-		LinkedVertexArray* cellVertices = &*vertices.get(i);
-		unsigned int index = cellVertices->index;
-		for (unsigned int side = 0; side < 4; ++side)
-        {
-			
-            if (cellVertices->find(2 * side) == true)
-            {
-				// Link vertices 
-				VoronoiDiagram::HalfEdge* halfEdge = mDiagram.createHalfEdge(mDiagram.getFace(index));
-				halfEdge->origin = cellVertices->get(2 * side)->vertex;
-				halfEdge->destination = cellVertices->get(2 * side + 1)->vertex;
-				cellVertices->get(2 * side)->nextHalfEdge = halfEdge;
-				int x = ((2 * side) - 1);
-				if (x == -1) { x = 7;}
-				if (cellVertices->find(x))
-					cellVertices->get(x)->nextHalfEdge = halfEdge;
-				halfEdge->prev = cellVertices->get(2 * side)->prevHalfEdge;
-				if (cellVertices->get(2 * side)->prevHalfEdge != nullptr)
-					cellVertices->get(2 * side)->prevHalfEdge->next = halfEdge;
-				cellVertices->get(2 * side + 1)->prevHalfEdge = halfEdge;
-				if (cellVertices->find((2 * side + 2)) % 8)
-					cellVertices->get(2 * side + 2)->prevHalfEdge = halfEdge;
-				halfEdge->next = cellVertices->get(2 * side + 1)->nextHalfEdge;
-				if (cellVertices->get(2 * side + 1)->nextHalfEdge != nullptr)
-					cellVertices->get(2 * side + 1)->nextHalfEdge->prev = halfEdge;
-            }
-        }
-    }
-    return true; 
-}
-
-// Linked Vertex
-
-void FortuneAlgorithm::LinkedVertex::setData(LinkedVertex* ptr) {
-	this->nextHalfEdge = ptr->nextHalfEdge;
-	this->prevHalfEdge = ptr->prevHalfEdge;
-	this->vertex = ptr->vertex;
-}
-
-// LinkedVertexList
-
-FortuneAlgorithm::LinkedVertexList::LinkedVertexList() {
-	head = nullptr;
-	tail = nullptr;
-}
-
-void FortuneAlgorithm::LinkedVertexList::emplace_back(LinkedVertex* e) {
-	LinkedVertex *tmp = head;
-	e->listNext = nullptr;
-
-	if (head == nullptr)			// If list is empty make Event e the head
-	{
-		head = e;
-		tail = e;
-		return;
-	}
-
-	while (tmp->listNext != nullptr)		// Else traverse list until the last node
-		tmp = tmp->listNext;
-
-	tmp->listNext = e;					// Set tail's next as e
-	tail = e;						// Set e as new tail
-	return;
-}
-
-FortuneAlgorithm::LinkedVertex* FortuneAlgorithm::LinkedVertexList::back() {
-	return tail;
-}
-
-
-// LinkedVertexArray
-
-FortuneAlgorithm::LinkedVertexArray::LinkedVertexArray(unsigned int i, unsigned int o) {
-	index = i;
-	order = o;
-}
-
-FortuneAlgorithm::LinkedVertex* FortuneAlgorithm::LinkedVertexArray::initialize(unsigned int i) {
-	// Base Case: If head is null then make the new LinkedVertexArray the head
-	if (head == nullptr) {
-		head = new LinkedVertex();
-		head->index = i;
-		head->arrayNext = nullptr;
-		mSize++;
-		return head;
-	}
-	else {				// Else initialize new linked vertex and add it to the front
-		LinkedVertex* tmp = new LinkedVertex();
-		tmp->index = i;
-		tmp->arrayNext = head;
-		head = tmp;
-		mSize++;
-		return head;
-	}
-}
-
-FortuneAlgorithm::LinkedVertex*& FortuneAlgorithm::LinkedVertexArray::get(int i) {
-	LinkedVertex* tmp = head;
-	while (tmp != nullptr) {
-		if (tmp->index == i)
-			return tmp;
-		tmp = tmp->arrayNext;
-	}
-	tmp = initialize(i);
-	return tmp;
-}
-
-bool FortuneAlgorithm::LinkedVertexArray::isEmpty() {
-	if (head == nullptr) {
-		return true;
-	}
-	else {
-		return false;
-	}
-}
-
-bool FortuneAlgorithm::LinkedVertexArray::find(int i) {
-	LinkedVertex* tmp = head;
-	while (tmp != nullptr) {
-		if (tmp->index == i)
-			return true;
-		tmp = tmp->arrayNext;
-	}
-	return false;
-}
-
-FortuneAlgorithm::LinkedVertex* FortuneAlgorithm::LinkedVertexArray::operator[](unsigned int i) {
-	LinkedVertex* tmp = head;
-	while (tmp != nullptr) {
-		if (tmp->index == i)
-			return tmp;
-		tmp = tmp->arrayNext;
-	}
-	return initialize(i);
-}
-
-// Unordered Linked Vertex Array Map
-
-FortuneAlgorithm::UnorderedMapLVA::UnorderedMapLVA() {
-	head = nullptr;
-	mSize = 0;
-}
-
-bool FortuneAlgorithm::UnorderedMapLVA::find(unsigned int i) {
-	LinkedVertexArray* tmp = head;  // Initialize current 
-	while (tmp != nullptr)
-	{
-		if (tmp->index == i)
-			return true;
-		tmp = tmp->next;
-	}
-	return false;
-}
-
-void FortuneAlgorithm::UnorderedMapLVA::initialize(unsigned int index) {
-	// Base Case: If head is null then make the new LinkedVertexArray the head
-	if (head == nullptr) {
-		head = new LinkedVertexArray(index, mSize);
-		head->next = nullptr;
-		mSize++;
-		return;
-	}
-	else {				// Else initialize new array and add it to the front
-		LinkedVertexArray* tmp = new LinkedVertexArray(index, mSize);
-		tmp->next = head;
-		head = tmp;
-		mSize++;
-		return;
-	}
-}
-
-FortuneAlgorithm::LinkedVertexArray* FortuneAlgorithm::UnorderedMapLVA::get(unsigned int i) {
-	LinkedVertexArray* tmp = head;
-	while (tmp != nullptr) {
-		if (tmp->order == i)
-			return tmp;
-		tmp = tmp->next;
-	}
-}
-
-FortuneAlgorithm::LinkedVertexArray* FortuneAlgorithm::UnorderedMapLVA::operator[](unsigned int i) {
-	LinkedVertexArray* tmp = head;
-	while (tmp != nullptr) {
-		if (tmp->index == i) 
-			return tmp;
-		tmp = tmp->next;
-	}
-}
-
-double FortuneAlgorithm::min(double x, double y) {
-	if (x < y)
-		return x;
-	else
-		return y;
-}
-
-double FortuneAlgorithm::max(double x, double y) {
-	if (x > y)
-		return x;
-	else
-		return y;
+    return mDiagram.bound(box);
 }
 
+// Instantiations for the available beachlines
+template class BasicFortuneAlgorithm<Beachline>;
+template class BasicFortuneAlgorithm<FlatBeachline>;
+template class BasicFortuneAlgorithm<BTreeBeachline>;
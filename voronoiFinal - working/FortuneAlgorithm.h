@@ -2,132 +2,107 @@
 
 // My includes
 #include "PriorityQueue.h"
+#include "EventPool.h"
 #include "VoronoiDiagram.h"
 #include "Beachline.h"
+#include "FlatBeachline.h"
+#include "BTreeBeachline.h"
 #include "Vector2Vector.h"
 
 
 struct Arc;
 class Event;
 
-class FortuneAlgorithm
+// The beachline is chosen at compile time among Beachline (red-black tree),
+// FlatBeachline (array with a gap) and BTreeBeachline (B+-tree)
+template<typename BeachlineType = Beachline>
+class BasicFortuneAlgorithm
 {
 public:
-    
-    FortuneAlgorithm(Vector2Vector points);
-    ~FortuneAlgorithm();
+    // Margin of the bounding box around the clipping box in constructClipped, as a fraction of the
+    // width plus the height of the clipping box
+    static constexpr double BOUNDING_MARGIN = 0.05;
+
+    // Every structure of the algorithm and of its diagram takes its memory from the resource, nullptr
+    // for the default one. Once the storage has grown to the largest input, a construction that
+    // starts with reset allocates nothing.
+    explicit BasicFortuneAlgorithm(MemoryResource* resource = nullptr);
+    BasicFortuneAlgorithm(const Vector2Vector& points, MemoryResource* resource = nullptr);
+    // The points are read in place from the caller's coordinates
+    BasicFortuneAlgorithm(PointSpan points, MemoryResource* resource = nullptr);
+    ~BasicFortuneAlgorithm();
+
+    // Start over with new points, all the internal storage keeps its capacity
+    void reset(const Vector2Vector& points);
+    void reset(PointSpan points);
+    // Same but the sites are the previous ones moved a little, the previous order is used to sort them
+    void moveSites(PointSpan points);
 
     void construct();
     bool bound(Box box);
-
-    VoronoiDiagram getDiagram();
+    // Construct, bound on a box slightly bigger than box, then hand over the diagram intersected with
+    // box in diagram. The storage of the diagram given in diagram is kept for the next reset. Returns
+    // false if the intersection failed.
+    bool constructClipped(Box box, VoronoiDiagram& diagram);
+
+    // View on the diagram being built
+    const VoronoiDiagram& getDiagram() const;
+    // Hand over the diagram, the algorithm must be reset before being used again
+    VoronoiDiagram takeDiagram();
+    // Give back a diagram that is not needed anymore, its storage and its resource are reused by the next reset
+    void recycleDiagram(VoronoiDiagram&& diagram);
 
 private:
+    // The parallel construction sorts the sites as a single sweep does
+    template<typename T> friend class BasicParallelFortuneAlgorithm;
+
     VoronoiDiagram mDiagram;
-    Beachline mBeachline;
+    BeachlineType mBeachline;
+    EventPool mEventPool;
     PriorityQueue mEvents;
     double mBeachlineY;
+    // Last arc inserted while all the sites swept are on the first line, nullptr afterwards
+    Arc* mFirstLineArc = nullptr;
+
+    // Sites sorted by decreasing y, only circle events go in the queue
+    struct SiteKey
+    {
+        unsigned long long key;
+        unsigned int index;
+    };
+    IndexPool<SiteKey> mSiteKeys;
+    IndexPool<SiteKey> mSiteKeysBuffer;
+    // Number of shifts per site after which the previous order is not worth it
+    static constexpr unsigned int MAX_SHIFTS_PER_SITE = 8;
+    // Number of sites up to which they are sorted by insertion instead of radix sort
+    static constexpr unsigned int MAX_INSERTION_SORT_SITES = 64;
+    bool mReuseSiteOrder = false;
+
+    void clear();
 
     // Algorithm
-    void handleSiteEvent(Event* event);
+    void handleSiteEvent(VoronoiDiagram::Site* site);
     void handleCircleEvent(Event* event);
 
+    // Sites
+    void sortSites();
+    bool sortFromPreviousOrder();
+    static unsigned long long getSortKey(double y);
+
     // Arcs
     Arc* breakArc(Arc* arc, VoronoiDiagram::Site* site);
-    void removeArc(Arc* arc, VoronoiDiagram::Vertex* vertex);
-
-    // Breakpoint
-    bool isMovingRight(const Arc* left, const Arc* right) const;
-    double getInitialX(const Arc* left, const Arc* right, bool movingRight) const;
+    void insertArcBeside(VoronoiDiagram::Site* site);
+    void removeArc(Arc* arc, unsigned int vertex);
 
     // Edges
     void addEdge(Arc* left, Arc* right);
-    void setOrigin(Arc* left, Arc* right, VoronoiDiagram::Vertex* vertex);
-    void setDestination(Arc* left, Arc* right, VoronoiDiagram::Vertex* vertex);
-    void setPrevHalfEdge(VoronoiDiagram::HalfEdge* prev, VoronoiDiagram::HalfEdge* next);
+    void setOrigin(Arc* left, Arc* right, unsigned int vertex);
+    void setDestination(Arc* left, Arc* right, unsigned int vertex);
+    void setPrevHalfEdge(unsigned int prev, unsigned int next);
 
     // Events
     void addEvent(Arc* left, Arc* middle, Arc* right);
     void deleteEvent(Arc* arc);
-    Vector2 computeConvergencePoint(const Vector2& point1, const Vector2& point2, const Vector2& point3, double& y) const;
-
-    // Bounding
-
-    struct LinkedVertex
-    {
-        VoronoiDiagram::HalfEdge* prevHalfEdge;
-        VoronoiDiagram::Vertex* vertex;
-        VoronoiDiagram::HalfEdge* nextHalfEdge;
-
-		// Operation
-		void setData(LinkedVertex* ptr);
-
-		//Used in LinkedVertexList
-		LinkedVertex* listNext;
-
-		// Used in LinkedVertexArray
-		LinkedVertex* arrayNext;
-		unsigned int index;
-    };
-
-
-public:
-	double min(double x, double y);
-	double max(double x, double y);
-
-	struct LinkedVertexList {
-		LinkedVertex* head;
-		LinkedVertex* tail;
-
-		// Constructor
-		LinkedVertexList();
-
-		// Operations
-		void emplace_back(LinkedVertex*);
-		LinkedVertex* back();
-	};
-
-	struct LinkedVertexArray {
-
-		// Used in UnorderedMapLVA
-		unsigned int index;
-		unsigned int order;
-		LinkedVertexArray* next;
-
-		int mSize = 0;
-		LinkedVertex* head = nullptr;
-
-		// Constructor
-		LinkedVertexArray(unsigned int i, unsigned int o);
-
-		// Operators
-		LinkedVertex* operator[](unsigned int i);
-
-		// Operations
-		LinkedVertex*& get(int i);
-		bool find(int i);
-		bool isEmpty();
-		LinkedVertex* initialize(unsigned int i);
-	};
-
-	// Unordered Linked Vertex Array Map
-	struct UnorderedMapLVA {
-
-		LinkedVertexArray *head;
-		int mSize;
-
-		// Constructor
-		UnorderedMapLVA();
-
-		// Operations
-		bool find(unsigned int i);
-		void initialize(unsigned int index);
-		LinkedVertexArray* get(unsigned int i);
-
-		// Operators
-		LinkedVertexArray* operator[](unsigned int i);
-
-	};
-
-	
 };
+
+using FortuneAlgorithm = BasicFortuneAlgorithm<Beachline>;
@@ -0,0 +1,224 @@
+#include "KdTree.h"
+// My includes
+#include "ParallelFor.h"
+
+static double getCoordinate(const Vector2& point, unsigned int axis)
+{
+    return axis == 0 ? point.x : point.y;
+}
+
+KdTree::KdTree(ThreadPool* threadPool, MemoryResource* resource) : mThreadPool(threadPool), mNodes(resource)
+{
+
+}
+
+void KdTree::reset(PointSpan points)
+{
+    unsigned int nbPoints = points.size();
+    mNodes.resize(nbPoints);
+    for (unsigned int i = 0; i < nbPoints; ++i)
+        mNodes[i] = Node{points[i], i};
+
+    // The top levels are split by the calling thread, then each thread builds whole subtrees
+    unsigned int nbThreads = mThreadPool != nullptr ? mThreadPool->getNbThreads() : 1;
+    unsigned int nbLevels = 0;
+    while ((1u << nbLevels) < nbThreads && (nbPoints >> nbLevels) > 2 * PARALLEL_MIN_BLOCK_SIZE)
+        ++nbLevels;
+    for (unsigned int level = 0; level < nbLevels; ++level)
+    {
+        for (unsigned int i = 0; i < (1u << level); ++i)
+        {
+            unsigned int begin = 0;
+            unsigned int end = nbPoints;
+            for (unsigned int bit = level; bit > 0; --bit)
+            {
+                unsigned int mid = begin + (end - begin) / 2;
+                if ((i >> (bit - 1)) & 1)
+                    begin = mid + 1;
+                else
+                    end = mid;
+            }
+            select(begin, end, begin + (end - begin) / 2, level & 1);
+        }
+    }
+    parallelFor(mThreadPool, 1u << nbLevels, [this, nbPoints, nbLevels](unsigned int first, unsigned int last)
+    {
+        for (unsigned int i = first; i < last; ++i)
+        {
+            unsigned int begin = 0;
+            unsigned int end = nbPoints;
+            for (unsigned int bit = nbLevels; bit > 0; --bit)
+            {
+                unsigned int mid = begin + (end - begin) / 2;
+                if ((i >> (bit - 1)) & 1)
+                    begin = mid + 1;
+                else
+                    end = mid;
+            }
+            build(begin, end, nbLevels);
+        }
+    }, 1);
+}
+
+unsigned int KdTree::size() const
+{
+    return mNodes.size();
+}
+
+unsigned int KdTree::getSite(unsigned int i) const
+{
+    return mNodes[i].site;
+}
+
+unsigned int KdTree::getNearestSites(const Vector2& point, unsigned int k, unsigned int* sites, double* squaredDistances) const
+{
+    Neighbors neighbors{sites, squaredDistances, k, 0};
+    if (k > 0)
+        search(0, mNodes.size(), 0, point, neighbors);
+    // Heapsort of the max-heap, the farthest points go to the end
+    for (unsigned int i = neighbors.size; i > 1; --i)
+    {
+        unsigned int site = sites[0];
+        double squaredDistance = squaredDistances[0];
+        sites[0] = sites[i - 1];
+        squaredDistances[0] = squaredDistances[i - 1];
+        sites[i - 1] = site;
+        squaredDistances[i - 1] = squaredDistance;
+        siftDown(neighbors, 0, i - 1);
+    }
+    return neighbors.size;
+}
+
+// Construction
+
+void KdTree::build(unsigned int begin, unsigned int end, unsigned int depth)
+{
+    while (end - begin > LEAF_SIZE)
+    {
+        unsigned int mid = begin + (end - begin) / 2;
+        select(begin, end, mid, depth & 1);
+        build(begin, mid, depth + 1);
+        begin = mid + 1;
+        ++depth;
+    }
+}
+
+// Quickselect, the nth node gets the point it would have if the range were sorted on the axis,
+// the points before it are not greater and the points after it are not smaller
+void KdTree::select(unsigned int begin, unsigned int end, unsigned int nth, unsigned int axis)
+{
+    while (end - begin > 2)
+    {
+        // Median of three as the pivot
+        double a = getCoordinate(mNodes[begin].point, axis);
+        double b = getCoordinate(mNodes[begin + (end - begin) / 2].point, axis);
+        double c = getCoordinate(mNodes[end - 1].point, axis);
+        double pivot = a < b ? (b < c ? b : (a < c ? c : a)) : (a < c ? a : (b < c ? c : b));
+        // Hoare partition, [begin, j] is not greater than the pivot and [i, end) is not smaller
+        unsigned int i = begin;
+        unsigned int j = end - 1;
+        while (i <= j)
+        {
+            while (getCoordinate(mNodes[i].point, axis) < pivot)
+                ++i;
+            while (getCoordinate(mNodes[j].point, axis) > pivot)
+                --j;
+            if (i <= j)
+            {
+                Node tmp = mNodes[i];
+                mNodes[i] = mNodes[j];
+                mNodes[j] = tmp;
+                ++i;
+                if (j == 0)
+                    break;
+                --j;
+            }
+        }
+        if (nth <= j && j + 1 > begin)
+            end = j + 1;
+        else if (nth >= i)
+            begin = i;
+        else
+            return;
+    }
+    if (end - begin == 2 && getCoordinate(mNodes[begin].point, axis) > getCoordinate(mNodes[begin + 1].point, axis))
+    {
+        Node tmp = mNodes[begin];
+        mNodes[begin] = mNodes[begin + 1];
+        mNodes[begin + 1] = tmp;
+    }
+}
+
+// Queries
+
+void KdTree::search(unsigned int begin, unsigned int end, unsigned int depth, const Vector2& point, Neighbors& neighbors) const
+{
+    while (end - begin > LEAF_SIZE)
+    {
+        unsigned int mid = begin + (end - begin) / 2;
+        const Node& node = mNodes[mid];
+        double difference = getCoordinate(point, depth & 1) - getCoordinate(node.point, depth & 1);
+        // The side of the point first, the other side only if it may be closer than the farthest neighbor
+        if (difference < 0.0)
+            search(begin, mid, depth + 1, point, neighbors);
+        else
+            search(mid + 1, end, depth + 1, point, neighbors);
+        addNeighbor(neighbors, node.site, point.getSquaredDistance(node.point));
+        if (neighbors.size == neighbors.capacity && difference * difference >= neighbors.squaredDistances[0])
+            return;
+        if (difference < 0.0)
+            begin = mid + 1;
+        else
+            end = mid;
+        ++depth;
+    }
+    for (unsigned int i = begin; i < end; ++i)
+    {
+        double squaredDistance = point.getSquaredDistance(mNodes[i].point);
+        if (neighbors.size < neighbors.capacity || squaredDistance < neighbors.squaredDistances[0])
+            addNeighbor(neighbors, mNodes[i].site, squaredDistance);
+    }
+}
+
+void KdTree::addNeighbor(Neighbors& neighbors, unsigned int site, double squaredDistance)
+{
+    if (neighbors.size < neighbors.capacity)
+    {
+        // Sift up the new leaf
+        unsigned int i = neighbors.size++;
+        while (i > 0 && neighbors.squaredDistances[(i - 1) / 2] < squaredDistance)
+        {
+            neighbors.sites[i] = neighbors.sites[(i - 1) / 2];
+            neighbors.squaredDistances[i] = neighbors.squaredDistances[(i - 1) / 2];
+            i = (i - 1) / 2;
+        }
+        neighbors.sites[i] = site;
+        neighbors.squaredDistances[i] = squaredDistance;
+    }
+    else if (squaredDistance < neighbors.squaredDistances[0])
+    {
+        // Replace the farthest neighbor
+        neighbors.sites[0] = site;
+        neighbors.squaredDistances[0] = squaredDistance;
+        siftDown(neighbors, 0, neighbors.size);
+    }
+}
+
+void KdTree::siftDown(Neighbors& neighbors, unsigned int i, unsigned int size)
+{
+    unsigned int site = neighbors.sites[i];
+    double squaredDistance = neighbors.squaredDistances[i];
+    while (2 * i + 1 < size)
+    {
+        unsigned int child = 2 * i + 1;
+        if (child + 1 < size && neighbors.squaredDistances[child + 1] > neighbors.squaredDistances[child])
+            ++child;
+        if (neighbors.squaredDistances[child] <= squaredDistance)
+            break;
+        neighbors.sites[i] = neighbors.sites[child];
+        neighbors.squaredDistances[i] = neighbors.squaredDistances[child];
+        i = child;
+    }
+    neighbors.sites[i] = site;
+    neighbors.squaredDistances[i] = squaredDistance;
+}
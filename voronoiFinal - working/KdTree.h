@@ -0,0 +1,59 @@
+#pragma once
+
+// My includes
+#include "IndexPool.h"
+#include "PointSpan.h"
+
+class ThreadPool;
+
+// Balanced 2-d tree over points, stored implicitly in one array: the median of a range is in
+// its middle and splits the range on x at even depths and on y at odd depths
+class KdTree
+{
+public:
+    // Ranges of at most this many points are scanned instead of split
+    static constexpr unsigned int LEAF_SIZE = 8;
+
+    // The construction is split over the threads of the pool, nullptr builds on the calling thread alone.
+    // The nodes are taken from the resource, only from the thread that calls reset, nullptr takes the
+    // memory from the default resource
+    KdTree(ThreadPool* threadPool = nullptr, MemoryResource* resource = nullptr);
+
+    // Builds the tree over new points, they are copied
+    void reset(PointSpan points);
+
+    unsigned int size() const;
+    // Sites in the order of the tree, where close sites are mostly close to each other
+    unsigned int getSite(unsigned int i) const;
+    // Writes the at most k points nearest to point by increasing distance and returns their number,
+    // the tree is only read so several threads can query it at the same time
+    unsigned int getNearestSites(const Vector2& point, unsigned int k, unsigned int* sites, double* squaredDistances) const;
+
+private:
+    struct Node
+    {
+        Vector2 point;
+        unsigned int site;
+    };
+
+    // Max-heap of the nearest points found so far, in the caller's arrays
+    struct Neighbors
+    {
+        unsigned int* sites;
+        double* squaredDistances;
+        unsigned int capacity;
+        unsigned int size;
+    };
+
+    ThreadPool* mThreadPool;
+    IndexPool<Node> mNodes;
+
+    // Construction
+    void build(unsigned int begin, unsigned int end, unsigned int depth);
+    void select(unsigned int begin, unsigned int end, unsigned int nth, unsigned int axis);
+
+    // Queries
+    void search(unsigned int begin, unsigned int end, unsigned int depth, const Vector2& point, Neighbors& neighbors) const;
+    static void addNeighbor(Neighbors& neighbors, unsigned int site, double squaredDistance);
+    static void siftDown(Neighbors& neighbors, unsigned int i, unsigned int size);
+};
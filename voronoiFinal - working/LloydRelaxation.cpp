@@ -0,0 +1,116 @@
+#include "LloydRelaxation.h"
+// STL
+#include <cmath>
+
+template<typename BeachlineType>
+BasicLloydRelaxation<BeachlineType>::BasicLloydRelaxation(Box box, unsigned int nbThreads, MemoryResource* resource) :
+    mAlgorithm(resource), mDiagram(resource), mBox(box), mThreadPool(nbThreads, resource), mHasOrder(false), mMaxDisplacement(0.0),
+    mEnergy(0.0), mX(resource), mY(resource), mCentroidX(resource), mCentroidY(resource), mArea(resource), mEnergies(resource)
+{
+
+}
+
+template<typename BeachlineType>
+void BasicLloydRelaxation<BeachlineType>::reset(PointSpan points)
+{
+    unsigned int nbSites = points.size();
+    mX.resize(nbSites);
+    mY.resize(nbSites);
+    for (unsigned int i = 0; i < nbSites; ++i)
+    {
+        mX[i] = points.getX(i);
+        mY[i] = points.getY(i);
+    }
+    mCentroidX.resize(nbSites);
+    mCentroidY.resize(nbSites);
+    mArea.resize(nbSites);
+    mEnergies.resize(nbSites);
+    mHasOrder = false;
+    mMaxDisplacement = 0.0;
+    mEnergy = 0.0;
+}
+
+template<typename BeachlineType>
+bool BasicLloydRelaxation<BeachlineType>::step()
+{
+    if (mHasOrder)
+        mAlgorithm.moveSites(getSites());
+    else
+        mAlgorithm.reset(getSites());
+    mHasOrder = true;
+    mMaxDisplacement = 0.0;
+    // The storage of the previous diagram is reused by the next construction
+    if (!mAlgorithm.constructClipped(mBox, mDiagram))
+        return false;
+
+    // Move the sites to the centroids
+    unsigned int nbSites = mX.size();
+    VoronoiDiagram::CellMeasures measures = {mCentroidX.mData, mCentroidY.mData, mArea.mData, nullptr, mEnergies.mData};
+    mDiagram.computeCellMeasures(measures, &mThreadPool);
+    double squaredMaxDisplacement = 0.0;
+    mEnergy = 0.0;
+    for (unsigned int i = 0; i < nbSites; ++i)
+    {
+        // A degenerate cell keeps its site
+        if (!(mArea[i] > 0.0))
+            continue;
+        double dx = mCentroidX[i] - mX[i];
+        double dy = mCentroidY[i] - mY[i];
+        double squaredDisplacement = dx * dx + dy * dy;
+        if (squaredDisplacement > squaredMaxDisplacement)
+            squaredMaxDisplacement = squaredDisplacement;
+        mX[i] = mCentroidX[i];
+        mY[i] = mCentroidY[i];
+        mEnergy += mEnergies[i];
+    }
+    mMaxDisplacement = std::sqrt(squaredMaxDisplacement);
+    return true;
+}
+
+template<typename BeachlineType>
+unsigned int BasicLloydRelaxation<BeachlineType>::run(unsigned int maxIterations, double maxDisplacement, double energyTolerance)
+{
+    unsigned int nbIterations = 0;
+    double previousEnergy = 0.0;
+    while (nbIterations < maxIterations)
+    {
+        if (!step())
+            break;
+        ++nbIterations;
+        if (mMaxDisplacement <= maxDisplacement)
+            break;
+        if (nbIterations > 1 && previousEnergy - mEnergy <= energyTolerance * previousEnergy)
+            break;
+        previousEnergy = mEnergy;
+    }
+    return nbIterations;
+}
+
+template<typename BeachlineType>
+PointSpan BasicLloydRelaxation<BeachlineType>::getSites() const
+{
+    return PointSpan(mX.mData, mY.mData, mX.size());
+}
+
+template<typename BeachlineType>
+const VoronoiDiagram& BasicLloydRelaxation<BeachlineType>::getDiagram() const
+{
+    return mDiagram;
+}
+
+template<typename BeachlineType>
+double BasicLloydRelaxation<BeachlineType>::getMaxDisplacement() const
+{
+    return mMaxDisplacement;
+}
+
+template<typename BeachlineType>
+double BasicLloydRelaxation<BeachlineType>::getEnergy() const
+{
+    return mEnergy;
+}
+
+// Instantiations for the available beachlines
+template class BasicLloydRelaxation<Beachline>;
+template class BasicLloydRelaxation<FlatBeachline>;
+template class BasicLloydRelaxation<BTreeBeachline>;
@@ -0,0 +1,56 @@
+#pragma once
+
+// My includes
+#include "FortuneAlgorithm.h"
+#include "ParallelFor.h"
+
+// Lloyd's algorithm: build the diagram, clip it to the box and move every site to the
+// centroid of its cell. The algorithm, the diagram and the per-site arrays are reused
+// between iterations, and each construction sorts the sites from the previous order.
+// All of them take their memory from the resource, only from the thread that calls the
+// relaxation: the threads of the centroids are started once with the relaxation and write into
+// arrays allocated beforehand.
+template<typename BeachlineType = Beachline>
+class BasicLloydRelaxation
+{
+public:
+    // The sites must be inside the box, nbThreads = 0 uses all the hardware threads for the centroids,
+    // nullptr takes the memory from the default resource
+    BasicLloydRelaxation(Box box, unsigned int nbThreads = 0, MemoryResource* resource = nullptr);
+
+    // Start over with new sites, they are copied
+    void reset(PointSpan points);
+
+    // One iteration, returns false if the diagram could not be clipped and then the sites do not move
+    bool step();
+    // Iterate until the largest displacement is at most maxDisplacement or the energy decreased
+    // by less than energyTolerance relatively, returns the number of iterations done
+    unsigned int run(unsigned int maxIterations, double maxDisplacement, double energyTolerance);
+
+    // Accessors
+    PointSpan getSites() const;
+    // Diagram of the sites before the last step
+    const VoronoiDiagram& getDiagram() const;
+    // Largest displacement of a site during the last step
+    double getMaxDisplacement() const;
+    // Sum over the cells of the integral of the squared distance to the site before the last step
+    double getEnergy() const;
+
+private:
+    BasicFortuneAlgorithm<BeachlineType> mAlgorithm;
+    VoronoiDiagram mDiagram;
+    Box mBox;
+    ThreadPool mThreadPool;
+    bool mHasOrder;
+    double mMaxDisplacement;
+    double mEnergy;
+    // Sites and cell measures, one entry per site
+    IndexPool<double> mX;
+    IndexPool<double> mY;
+    IndexPool<double> mCentroidX;
+    IndexPool<double> mCentroidY;
+    IndexPool<double> mArea;
+    IndexPool<double> mEnergies;
+};
+
+using LloydRelaxation = BasicLloydRelaxation<Beachline>;
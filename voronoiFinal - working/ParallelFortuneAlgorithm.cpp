@@ -0,0 +1,630 @@
+#include "ParallelFortuneAlgorithm.h"
+// STL
+#include <cfloat>
+#include <cmath>
+
+// Relative margin on the squared radius of the circles, a site almost on a circle is assumed to be in it
+constexpr double CIRCLE_TOLERANCE = 1e-12;
+
+template<typename BucketBox>
+static void extendBox(BucketBox& box, double x, double y)
+{
+    box.minX = x < box.minX ? x : box.minX;
+    box.minY = y < box.minY ? y : box.minY;
+    box.maxX = x > box.maxX ? x : box.maxX;
+    box.maxY = y > box.maxY ? y : box.maxY;
+}
+
+template<typename BucketBox>
+static void mergeBox(BucketBox& box, const BucketBox& other)
+{
+    box.minX = other.minX < box.minX ? other.minX : box.minX;
+    box.minY = other.minY < box.minY ? other.minY : box.minY;
+    box.maxX = other.maxX > box.maxX ? other.maxX : box.maxX;
+    box.maxY = other.maxY > box.maxY ? other.maxY : box.maxY;
+}
+
+// Squared distance from the point to the box, infinite if the box is empty
+template<typename BucketBox>
+static double getSquaredDistance(const BucketBox& box, const Vector2& point)
+{
+    if (box.minX > box.maxX)
+        return DBL_MAX;
+    double dx = point.x < box.minX ? box.minX - point.x : (point.x > box.maxX ? point.x - box.maxX : 0.0);
+    double dy = point.y < box.minY ? box.minY - point.y : (point.y > box.maxY ? point.y - box.maxY : 0.0);
+    return dx * dx + dy * dy;
+}
+
+// True if a point of the box may be in the open half plane (p - origin) . normal > 0
+template<typename BucketBox>
+static bool mayIntersect(const BucketBox& box, const Vector2& origin, const Vector2& normal)
+{
+    if (box.minX > box.maxX)
+        return false;
+    double x0 = (box.minX - origin.x) * normal.x;
+    double x1 = (box.maxX - origin.x) * normal.x;
+    double y0 = (box.minY - origin.y) * normal.y;
+    double y1 = (box.maxY - origin.y) * normal.y;
+    return (x0 > x1 ? x0 : x1) + (y0 > y1 ? y0 : y1) >= 0.0;
+}
+
+template<typename BeachlineType>
+BasicParallelFortuneAlgorithm<BeachlineType>::BasicParallelFortuneAlgorithm(unsigned int nbThreads, MemoryResource* resource,
+    MemoryResource* const* stripResources) :
+    mPoints(static_cast<const double*>(nullptr), 0), mThreadPool(nbThreads, resource),
+    mResource(resource != nullptr ? resource : getDefaultMemoryResource()), mDiagram(resource), mFallback(resource),
+    mStrips(nullptr), mNbAllocatedStrips(mThreadPool.getNbThreads()), mNbStrips(0), mSiteKeys(resource),
+    mSiteKeysBuffer(resource), mDigitCounts(resource), mOrder(resource), mCoordinates(resource), mNbBuckets(0),
+    mMinX(0.0), mBucketScale(0.0), mHaloBuckets(0), mCellBuckets(resource), mBucketExtremes(resource),
+    mBuckets(resource), mBlocks(resource), mPartialBoxes(resource), mPartialCounts(resource),
+    mPartialExtremes(resource), mStitcher(true, &mThreadPool, resource)
+{
+    // The strips are built at once with their resources, they allocate nothing before their first sweep
+    mStrips = static_cast<Strip*>(mResource->allocate(mNbAllocatedStrips * sizeof(Strip), alignof(Strip)));
+    for (unsigned int i = 0; i < mNbAllocatedStrips; ++i)
+        new (mStrips + i) Strip(stripResources != nullptr ? stripResources[i] : nullptr);
+}
+
+template<typename BeachlineType>
+BasicParallelFortuneAlgorithm<BeachlineType>::BasicParallelFortuneAlgorithm(PointSpan points, unsigned int nbThreads,
+    MemoryResource* resource, MemoryResource* const* stripResources) :
+    BasicParallelFortuneAlgorithm(nbThreads, resource, stripResources)
+{
+    reset(points);
+}
+
+template<typename BeachlineType>
+BasicParallelFortuneAlgorithm<BeachlineType>::~BasicParallelFortuneAlgorithm()
+{
+    for (unsigned int i = 0; i < mNbAllocatedStrips; ++i)
+        mStrips[i].~Strip();
+    mResource->deallocate(mStrips, mNbAllocatedStrips * sizeof(Strip), alignof(Strip));
+}
+
+template<typename BeachlineType>
+void BasicParallelFortuneAlgorithm<BeachlineType>::reset(PointSpan points)
+{
+    mPoints = points;
+    mNbStrips = 0;
+}
+
+template<typename BeachlineType>
+void BasicParallelFortuneAlgorithm<BeachlineType>::construct()
+{
+    if (!computeBuckets())
+    {
+        constructWithOneSweep();
+        return;
+    }
+    // Sweep the strips, each one writes the degrees of the cells it owns
+    mStitcher.resizeCells(mPoints.size());
+    mThreadPool.parallelFor(mNbStrips, [this](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+            sweepStrip(mStrips[i]);
+    }, 1);
+    for (unsigned int i = 0; i < mNbStrips; ++i)
+    {
+        if (!mStrips[i].isValid)
+        {
+            constructWithOneSweep();
+            return;
+        }
+    }
+    // Then the cells are copied one after the other
+    mStitcher.allocateSlots();
+    mThreadPool.parallelFor(mNbStrips, [this](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+            copyCells(mStrips[i]);
+    }, 1);
+    for (unsigned int i = 0; i < mNbStrips; ++i)
+    {
+        if (!mStrips[i].isValid)
+        {
+            constructWithOneSweep();
+            return;
+        }
+    }
+    if (!mStitcher.stitch(mDiagram, mPoints, mOrder))
+        constructWithOneSweep();
+}
+
+template<typename BeachlineType>
+bool BasicParallelFortuneAlgorithm<BeachlineType>::bound(Box box)
+{
+    return mDiagram.bound(box);
+}
+
+template<typename BeachlineType>
+const VoronoiDiagram& BasicParallelFortuneAlgorithm<BeachlineType>::getDiagram() const
+{
+    return mDiagram;
+}
+
+template<typename BeachlineType>
+VoronoiDiagram BasicParallelFortuneAlgorithm<BeachlineType>::takeDiagram()
+{
+    return static_cast<VoronoiDiagram&&>(mDiagram);
+}
+
+template<typename BeachlineType>
+unsigned int BasicParallelFortuneAlgorithm<BeachlineType>::getNbStrips() const
+{
+    return mNbStrips;
+}
+
+// The sweep has its own algorithm so that the diagram stays with the resource of the calling thread
+template<typename BeachlineType>
+void BasicParallelFortuneAlgorithm<BeachlineType>::constructWithOneSweep()
+{
+    mNbStrips = 1;
+    mFallback.recycleDiagram(static_cast<VoronoiDiagram&&>(mDiagram));
+    mFallback.reset(mPoints);
+    mFallback.construct();
+    mDiagram = mFallback.takeDiagram();
+}
+
+// Partition
+
+// Sorts the sites in the order of the sweep, buckets their abscissas and cuts the buckets in
+// strips of about the same number of sites, returns false if a single sweep should be used
+template<typename BeachlineType>
+bool BasicParallelFortuneAlgorithm<BeachlineType>::computeBuckets()
+{
+    unsigned int nbSites = mPoints.size();
+    unsigned int nbStrips = mThreadPool.getNbThreads();
+    if (nbStrips > nbSites / MIN_SITES_PER_STRIP)
+        nbStrips = nbSites / MIN_SITES_PER_STRIP;
+    if (nbStrips < 2)
+        return false;
+    mNbStrips = nbStrips;
+
+    // Bounding box of the sites, one chunk of sites per strip
+    const BucketBox emptyBox = {DBL_MAX, DBL_MAX, -DBL_MAX, -DBL_MAX};
+    mPartialBoxes.resize(nbStrips);
+    mThreadPool.parallelFor(nbStrips, [this, nbSites, nbStrips, emptyBox](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            BucketBox box = emptyBox;
+            for (unsigned int j = getChunkStart(nbSites, nbStrips, i); j < getChunkStart(nbSites, nbStrips, i + 1); ++j)
+                extendBox(box, mPoints.getX(j), mPoints.getY(j));
+            mPartialBoxes[i] = box;
+        }
+    }, 1);
+    BucketBox box = emptyBox;
+    for (unsigned int i = 0; i < nbStrips; ++i)
+        mergeBox(box, mPartialBoxes[i]);
+    // All the sites on a vertical or horizontal line
+    if (!(box.maxX > box.minX && box.maxY > box.minY))
+        return false;
+    mNbBuckets = nbStrips * BUCKETS_PER_STRIP;
+    mMinX = box.minX;
+    mBucketScale = mNbBuckets / (box.maxX - box.minX);
+    sortSites(nbStrips);
+
+    // Coordinates and buckets of the cells, numbers of sites and first and last cells of the
+    // buckets, computed per chunk of cells then merged
+    mCoordinates.resize(2 * nbSites);
+    mCellBuckets.resize(nbSites);
+    mPartialCounts.resize(nbStrips * mNbBuckets);
+    mPartialExtremes.resize(2 * nbStrips * mNbBuckets);
+    mThreadPool.parallelFor(nbStrips, [this, nbSites, nbStrips](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            unsigned int* counts = &mPartialCounts[i * mNbBuckets];
+            unsigned int* extremes = &mPartialExtremes[2 * i * mNbBuckets];
+            for (unsigned int j = 0; j < mNbBuckets; ++j)
+            {
+                counts[j] = 0;
+                extremes[2 * j] = VoronoiDiagram::NONE;
+                extremes[2 * j + 1] = VoronoiDiagram::NONE;
+            }
+            for (unsigned int j = getChunkStart(nbSites, nbStrips, i); j < getChunkStart(nbSites, nbStrips, i + 1); ++j)
+            {
+                double x = mPoints.getX(mOrder[j]);
+                mCoordinates[2 * j] = x;
+                mCoordinates[2 * j + 1] = mPoints.getY(mOrder[j]);
+                unsigned int bucket = getBucket(x);
+                mCellBuckets[j] = bucket;
+                ++counts[bucket];
+                if (extremes[2 * bucket] == VoronoiDiagram::NONE)
+                    extremes[2 * bucket] = j;
+                extremes[2 * bucket + 1] = j;
+            }
+        }
+    }, 1);
+    // The first chunk receives the totals
+    mBucketExtremes.resize(2 * mNbBuckets);
+    mThreadPool.parallelFor(mNbBuckets, [this, nbStrips](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            mBucketExtremes[2 * i] = mPartialExtremes[2 * i];
+            mBucketExtremes[2 * i + 1] = mPartialExtremes[2 * i + 1];
+            for (unsigned int j = 1; j < nbStrips; ++j)
+            {
+                const unsigned int* extremes = &mPartialExtremes[2 * (j * mNbBuckets + i)];
+                if (mBucketExtremes[2 * i] == VoronoiDiagram::NONE)
+                    mBucketExtremes[2 * i] = extremes[0];
+                if (extremes[1] != VoronoiDiagram::NONE)
+                    mBucketExtremes[2 * i + 1] = extremes[1];
+                mPartialCounts[i] += mPartialCounts[j * mNbBuckets + i];
+            }
+        }
+    });
+
+    // Boxes of the other sites of the buckets, the ones that may be missing from a sweep
+    mPartialBoxes.resize(nbStrips * mNbBuckets);
+    mThreadPool.parallelFor(nbStrips, [this, nbSites, nbStrips, emptyBox](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            BucketBox* boxes = &mPartialBoxes[i * mNbBuckets];
+            for (unsigned int j = 0; j < mNbBuckets; ++j)
+                boxes[j] = emptyBox;
+            for (unsigned int j = getChunkStart(nbSites, nbStrips, i); j < getChunkStart(nbSites, nbStrips, i + 1); ++j)
+            {
+                unsigned int bucket = mCellBuckets[j];
+                if (j != mBucketExtremes[2 * bucket] && j != mBucketExtremes[2 * bucket + 1])
+                    extendBox(boxes[bucket], mCoordinates[2 * j], mCoordinates[2 * j + 1]);
+            }
+        }
+    }, 1);
+    mBuckets.resize(mNbBuckets);
+    mThreadPool.parallelFor(mNbBuckets, [this, nbStrips](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            mBuckets[i] = mPartialBoxes[i];
+            for (unsigned int j = 1; j < nbStrips; ++j)
+                mergeBox(mBuckets[i], mPartialBoxes[j * mNbBuckets + i]);
+        }
+    });
+    mBlocks.resize(mNbBuckets / BUCKETS_PER_BLOCK);
+    for (unsigned int i = 0; i < mBlocks.size(); ++i)
+    {
+        mBlocks[i] = emptyBox;
+        for (unsigned int j = 0; j < BUCKETS_PER_BLOCK; ++j)
+            mergeBox(mBlocks[i], mBuckets[i * BUCKETS_PER_BLOCK + j]);
+    }
+
+    // Cut the strips
+    unsigned int strip = 0;
+    unsigned long long count = 0;
+    mStrips[0].firstBucket = 0;
+    for (unsigned int i = 0; i < mNbBuckets; ++i)
+    {
+        count += mPartialCounts[i];
+        while (strip + 1 < nbStrips && count * nbStrips >= static_cast<unsigned long long>(nbSites) * (strip + 1))
+        {
+            mStrips[strip].lastBucket = i + 1;
+            ++strip;
+            mStrips[strip].firstBucket = i + 1;
+        }
+    }
+    mStrips[nbStrips - 1].lastBucket = mNbBuckets;
+
+    // The first halo is a few times the average distance between the sites
+    double spacing = std::sqrt((box.maxX - box.minX) * (box.maxY - box.minY) / nbSites);
+    double haloBuckets = std::ceil(HALO_WIDTH * spacing * mBucketScale);
+    mHaloBuckets = haloBuckets < 1.0 ? 1 : (haloBuckets < mNbBuckets ? static_cast<unsigned int>(haloBuckets) : mNbBuckets);
+    return true;
+}
+
+// LSD radix sort on the keys of BasicFortuneAlgorithm, each pass counts the digits per chunk
+// then scatters the chunks in order so that the ties are broken by index as in a single sweep
+template<typename BeachlineType>
+void BasicParallelFortuneAlgorithm<BeachlineType>::sortSites(unsigned int nbChunks)
+{
+    unsigned int nbSites = mPoints.size();
+    mSiteKeys.resize(nbSites);
+    mSiteKeysBuffer.resize(nbSites);
+    mDigitCounts.resize(256 * nbChunks);
+    SiteKey* src = &mSiteKeys[0];
+    SiteKey* dst = &mSiteKeysBuffer[0];
+    mThreadPool.parallelFor(nbSites, [this, src](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+            src[i] = SiteKey{BasicFortuneAlgorithm<BeachlineType>::getSortKey(mPoints.getY(i)), i};
+    });
+    for (unsigned int shift = 0; shift < 64; shift += 8)
+    {
+        mThreadPool.parallelFor(nbChunks, [this, nbSites, nbChunks, shift, src](unsigned int begin, unsigned int end)
+        {
+            for (unsigned int i = begin; i < end; ++i)
+            {
+                unsigned int* counts = &mDigitCounts[256 * i];
+                for (unsigned int digit = 0; digit < 256; ++digit)
+                    counts[digit] = 0;
+                for (unsigned int j = getChunkStart(nbSites, nbChunks, i); j < getChunkStart(nbSites, nbChunks, i + 1); ++j)
+                    ++counts[(src[j].key >> shift) & 0xFF];
+            }
+        }, 1);
+        // The passes where all the keys share the same byte are skipped
+        unsigned int firstDigit = (src[0].key >> shift) & 0xFF;
+        unsigned int nbSameDigits = 0;
+        for (unsigned int i = 0; i < nbChunks; ++i)
+            nbSameDigits += mDigitCounts[256 * i + firstDigit];
+        if (nbSameDigits == nbSites)
+            continue;
+        unsigned int offset = 0;
+        for (unsigned int digit = 0; digit < 256; ++digit)
+        {
+            for (unsigned int i = 0; i < nbChunks; ++i)
+            {
+                unsigned int count = mDigitCounts[256 * i + digit];
+                mDigitCounts[256 * i + digit] = offset;
+                offset += count;
+            }
+        }
+        mThreadPool.parallelFor(nbChunks, [this, nbSites, nbChunks, shift, src, dst](unsigned int begin, unsigned int end)
+        {
+            for (unsigned int i = begin; i < end; ++i)
+            {
+                unsigned int* offsets = &mDigitCounts[256 * i];
+                for (unsigned int j = getChunkStart(nbSites, nbChunks, i); j < getChunkStart(nbSites, nbChunks, i + 1); ++j)
+                    dst[offsets[(src[j].key >> shift) & 0xFF]++] = src[j];
+            }
+        }, 1);
+        SiteKey* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+    mOrder.resize(nbSites);
+    mThreadPool.parallelFor(nbSites, [this, src](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+            mOrder[i] = src[i].index;
+    });
+}
+
+template<typename BeachlineType>
+unsigned int BasicParallelFortuneAlgorithm<BeachlineType>::getBucket(double x) const
+{
+    if (!(x > mMinX))
+        return 0;
+    double bucket = (x - mMinX) * mBucketScale;
+    return bucket < mNbBuckets ? static_cast<unsigned int>(bucket) : mNbBuckets - 1;
+}
+
+// Sweeps
+
+// Sweeps the strip with wider and wider halos until its cells are proved, then writes their degrees
+template<typename BeachlineType>
+void BasicParallelFortuneAlgorithm<BeachlineType>::sweepStrip(Strip& strip)
+{
+    strip.isValid = true;
+    unsigned int nbSites = mPoints.size();
+    strip.firstSweptBucket = strip.firstBucket > mHaloBuckets ? strip.firstBucket - mHaloBuckets : 0;
+    strip.lastSweptBucket = mNbBuckets - strip.lastBucket > mHaloBuckets ? strip.lastBucket + mHaloBuckets : mNbBuckets;
+    while (true)
+    {
+        // The cells are already in the order of the sweep, the strip does not sort them again and
+        // breaks the ties as a single sweep
+        strip.coordinates.clear();
+        strip.cells.clear();
+        for (unsigned int i = 0; i < nbSites; ++i)
+        {
+            unsigned int bucket = mCellBuckets[i];
+            if ((bucket >= strip.firstSweptBucket && bucket < strip.lastSweptBucket) ||
+                i == mBucketExtremes[2 * bucket] || i == mBucketExtremes[2 * bucket + 1])
+            {
+                strip.cells.push_back(i);
+                strip.coordinates.push_back(mCoordinates[2 * i]);
+                strip.coordinates.push_back(mCoordinates[2 * i + 1]);
+            }
+        }
+        strip.algorithm.reset(PointSpan(strip.coordinates.mData, strip.cells.size()));
+        strip.algorithm.construct();
+        if (strip.firstSweptBucket == 0 && strip.lastSweptBucket == mNbBuckets)
+            break;
+        strip.firstNeededBucket = strip.firstSweptBucket;
+        strip.lastNeededBucket = strip.lastSweptBucket;
+        if (areCellsProved(strip))
+            break;
+        // A side that misses sites grows to the buckets that were hit and at least twice as wide
+        if (strip.firstNeededBucket < strip.firstSweptBucket)
+        {
+            unsigned int halo = strip.firstBucket - strip.firstSweptBucket;
+            unsigned int first = strip.firstBucket > 2 * halo ? strip.firstBucket - 2 * halo : 0;
+            strip.firstSweptBucket = strip.firstNeededBucket < first ? strip.firstNeededBucket : first;
+        }
+        if (strip.lastNeededBucket > strip.lastSweptBucket)
+        {
+            unsigned int halo = strip.lastSweptBucket - strip.lastBucket;
+            unsigned int last = mNbBuckets - strip.lastBucket > 2 * halo ? strip.lastBucket + 2 * halo : mNbBuckets;
+            strip.lastSweptBucket = strip.lastNeededBucket > last ? strip.lastNeededBucket : last;
+        }
+    }
+    // Degrees of the cells, the half edges are read in the order of the sweep
+    const VoronoiDiagram& diagram = strip.algorithm.getDiagram();
+    for (unsigned int i = 0; i < strip.cells.size(); ++i)
+    {
+        if (isOwned(strip, strip.cells[i]))
+        {
+            mStitcher.cellOffsets[strip.cells[i]] = 0;
+            mStitcher.openCells[strip.cells[i]] = false;
+        }
+    }
+    const IndexPool<VoronoiDiagram::HalfEdge>& halfEdges = diagram.getHalfEdges();
+    for (unsigned int i = 0; i < halfEdges.size(); ++i)
+    {
+        unsigned int cell = strip.cells[diagram.getFace(halfEdges[i].incidentFace)->site];
+        if (!isOwned(strip, cell))
+            continue;
+        ++mStitcher.cellOffsets[cell];
+        if (halfEdges[i].origin == VoronoiDiagram::NONE)
+        {
+            // A cell between parallel edges can not be copied as one chain
+            if (mStitcher.openCells[cell])
+                strip.isValid = false;
+            mStitcher.openCells[cell] = true;
+        }
+    }
+    for (unsigned int i = 0; i < strip.cells.size(); ++i)
+    {
+        if (isOwned(strip, strip.cells[i]) && mStitcher.cellOffsets[strip.cells[i]] == 0)
+            strip.isValid = false;
+    }
+}
+
+// A cell is the one of the whole diagram if no site that was not swept is in the circle of one
+// of its vertices or beyond one of its infinite edges, the half edges of the owned cells are
+// read in the order of the sweep rather than cell by cell. All the tests are done so that the
+// buckets needed by the strip are known when it fails.
+template<typename BeachlineType>
+bool BasicParallelFortuneAlgorithm<BeachlineType>::areCellsProved(Strip& strip) const
+{
+    const VoronoiDiagram& diagram = strip.algorithm.getDiagram();
+    const IndexPool<VoronoiDiagram::HalfEdge>& halfEdges = diagram.getHalfEdges();
+    bool isProved = true;
+    for (unsigned int i = 0; i < halfEdges.size(); ++i)
+    {
+        const VoronoiDiagram::HalfEdge& edge = halfEdges[i];
+        unsigned int site = diagram.getFace(edge.incidentFace)->site;
+        if (!isOwned(strip, strip.cells[site]))
+            continue;
+        const Vector2& point = diagram.getSite(site)->point;
+        if (edge.origin != VoronoiDiagram::NONE)
+        {
+            const Vector2& vertex = diagram.getVertex(edge.origin)->point;
+            isProved = isCircleEmpty(strip, vertex, vertex.getSquaredDistance(point)) && isProved;
+        }
+        if (edge.origin != VoronoiDiagram::NONE && edge.destination != VoronoiDiagram::NONE)
+            continue;
+        const Vector2& neighbor = diagram.getSite(diagram.getFace(halfEdges[VoronoiDiagram::getTwin(i)].incidentFace)->site)->point;
+        Vector2 middle = (point + neighbor) * 0.5;
+        // The edge comes from infinity
+        if (edge.origin == VoronoiDiagram::NONE)
+            isProved = isHalfPlaneEmpty(strip, middle, (point - neighbor).getOrthogonal()) && isProved;
+        // The edge goes to infinity
+        if (edge.destination == VoronoiDiagram::NONE)
+            isProved = isHalfPlaneEmpty(strip, middle, (neighbor - point).getOrthogonal()) && isProved;
+    }
+    return isProved;
+}
+
+template<typename BeachlineType>
+bool BasicParallelFortuneAlgorithm<BeachlineType>::isCircleEmpty(Strip& strip, const Vector2& center, double squaredRadius) const
+{
+    // Only the buckets overlapping the circle horizontally are tested
+    double radius = std::sqrt(squaredRadius);
+    unsigned int firstBucket = getBucket(center.x - radius);
+    unsigned int lastBucket = getBucket(center.x + radius) + 1;
+    if (firstBucket >= strip.firstNeededBucket && lastBucket <= strip.lastNeededBucket)
+        return true;
+    double limit = squaredRadius * (1.0 + CIRCLE_TOLERANCE);
+    bool isEmpty = true;
+    for (unsigned int block = firstBucket / BUCKETS_PER_BLOCK; block * BUCKETS_PER_BLOCK < lastBucket; ++block)
+    {
+        if (getSquaredDistance(mBlocks[block], center) >= limit)
+            continue;
+        unsigned int end = (block + 1) * BUCKETS_PER_BLOCK < lastBucket ? (block + 1) * BUCKETS_PER_BLOCK : lastBucket;
+        for (unsigned int i = block * BUCKETS_PER_BLOCK > firstBucket ? block * BUCKETS_PER_BLOCK : firstBucket; i < end; ++i)
+        {
+            if ((i < strip.firstSweptBucket || i >= strip.lastSweptBucket) && getSquaredDistance(mBuckets[i], center) < limit)
+            {
+                isEmpty = false;
+                addNeededBucket(strip, i);
+            }
+        }
+    }
+    return isEmpty;
+}
+
+template<typename BeachlineType>
+bool BasicParallelFortuneAlgorithm<BeachlineType>::isHalfPlaneEmpty(Strip& strip, const Vector2& origin, const Vector2& normal) const
+{
+    bool isEmpty = true;
+    for (unsigned int block = 0; block < mBlocks.size(); ++block)
+    {
+        unsigned int begin = block * BUCKETS_PER_BLOCK;
+        unsigned int end = begin + BUCKETS_PER_BLOCK;
+        if ((begin >= strip.firstNeededBucket && end <= strip.lastNeededBucket) || !mayIntersect(mBlocks[block], origin, normal))
+            continue;
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            if ((i < strip.firstSweptBucket || i >= strip.lastSweptBucket) && mayIntersect(mBuckets[i], origin, normal))
+            {
+                isEmpty = false;
+                addNeededBucket(strip, i);
+            }
+        }
+    }
+    return isEmpty;
+}
+
+template<typename BeachlineType>
+void BasicParallelFortuneAlgorithm<BeachlineType>::addNeededBucket(Strip& strip, unsigned int bucket) const
+{
+    if (bucket < strip.firstNeededBucket)
+        strip.firstNeededBucket = bucket;
+    if (bucket + 1 > strip.lastNeededBucket)
+        strip.lastNeededBucket = bucket + 1;
+}
+
+// Half edge coming from infinity for an unbounded face, any half edge for a bounded one
+template<typename BeachlineType>
+unsigned int BasicParallelFortuneAlgorithm<BeachlineType>::getFirstHalfEdge(const VoronoiDiagram& diagram, unsigned int face)
+{
+    unsigned int outerComponent = diagram.getFace(face)->outerComponent;
+    if (outerComponent == VoronoiDiagram::NONE)
+        return VoronoiDiagram::NONE;
+    unsigned int halfEdge = outerComponent;
+    while (true)
+    {
+        unsigned int prev = diagram.getHalfEdge(halfEdge)->prev;
+        if (prev == VoronoiDiagram::NONE || prev == outerComponent)
+            return halfEdge;
+        halfEdge = prev;
+    }
+}
+
+template<typename BeachlineType>
+bool BasicParallelFortuneAlgorithm<BeachlineType>::isOwned(const Strip& strip, unsigned int cell) const
+{
+    unsigned int bucket = mCellBuckets[cell];
+    return bucket >= strip.firstBucket && bucket < strip.lastBucket;
+}
+
+// Stitching
+
+// Copies the owned cells in their slots, the strip is invalid if a cell is not one chain
+template<typename BeachlineType>
+void BasicParallelFortuneAlgorithm<BeachlineType>::copyCells(Strip& strip)
+{
+    const VoronoiDiagram& diagram = strip.algorithm.getDiagram();
+    for (unsigned int i = 0; i < strip.cells.size(); ++i)
+    {
+        if (!isOwned(strip, strip.cells[i]))
+            continue;
+        unsigned int slot = mStitcher.cellOffsets[strip.cells[i]];
+        unsigned int first = getFirstHalfEdge(diagram, diagram.getSite(i)->face);
+        unsigned int halfEdge = first;
+        do
+        {
+            const VoronoiDiagram::HalfEdge* edge = diagram.getHalfEdge(halfEdge);
+            unsigned int neighbor = diagram.getFace(diagram.getHalfEdge(VoronoiDiagram::getTwin(halfEdge))->incidentFace)->site;
+            mStitcher.neighbors[slot] = strip.cells[neighbor];
+            if (edge->origin != VoronoiDiagram::NONE)
+            {
+                mStitcher.origins[slot] = diagram.getVertex(edge->origin)->point;
+                mStitcher.slotVertices[slot] = 0;
+            }
+            else
+                mStitcher.slotVertices[slot] = VoronoiDiagram::NONE;
+            ++slot;
+            halfEdge = edge->next;
+        } while (halfEdge != VoronoiDiagram::NONE && halfEdge != first && slot < mStitcher.cellOffsets[strip.cells[i] + 1]);
+        if (slot != mStitcher.cellOffsets[strip.cells[i] + 1] || (halfEdge != VoronoiDiagram::NONE && halfEdge != first))
+            strip.isValid = false;
+    }
+}
+
+// Instantiations for the available beachlines
+template class BasicParallelFortuneAlgorithm<Beachline>;
+template class BasicParallelFortuneAlgorithm<FlatBeachline>;
+template class BasicParallelFortuneAlgorithm<BTreeBeachline>;
@@ -0,0 +1,158 @@
+#pragma once
+
+// My includes
+#include "FortuneAlgorithm.h"
+#include "CellStitcher.h"
+#include "ParallelFor.h"
+
+// Fortune's algorithm split over vertical strips swept in parallel.
+//
+// The sites are first sorted in the order of the sweep, in parallel, and the cells are numbered
+// in this order so that the strips and the stitching read them mostly sequentially. The abscissas
+// are bucketed and the strips are runs of buckets holding as many sites each.
+// A strip sweeps its own sites plus a halo of the neighboring buckets and the lowest and highest
+// sites of every bucket, so that the cells along the bottom and the top of the strip are closed
+// as in the whole diagram. One of its cells is the cell of the whole diagram when no site that
+// was not swept can be in the circle of a vertex or in the half plane beyond an infinite edge,
+// which is tested on the bounding boxes of the outer buckets. A strip with a cell that can not be
+// proved is swept again with the buckets that were hit and a halo at least twice as wide on their
+// side, until the halo covers all the sites if needed.
+//
+// The proved cells are then stitched along the seams into one diagram by a CellStitcher, an
+// unbounded cell starts with the half edge coming from infinity. Apart from the numbering of
+// the vertices and the half edges, the diagram is the one of BasicFortuneAlgorithm. The sites
+// in degenerate positions, e.g. cocircular across a seam, may be linked differently by two
+// strips: then the diagram is built by a single sweep.
+//
+// The diagram, the partition, the stitching and the array of the threads take their memory from
+// the resource of the algorithm, only from the thread that calls it. A strip takes all its memory
+// from its own resource, as the workers of BasicBatchFortuneAlgorithm do.
+template<typename BeachlineType = Beachline>
+class BasicParallelFortuneAlgorithm
+{
+public:
+    // Sites per strip below which fewer strips are used
+    static constexpr unsigned int MIN_SITES_PER_STRIP = 4096;
+    // Buckets of abscissas per strip, the strips and the halos are made of whole buckets
+    static constexpr unsigned int BUCKETS_PER_STRIP = 256;
+    // Buckets per block, the blocks are tested before their buckets
+    static constexpr unsigned int BUCKETS_PER_BLOCK = 16;
+    // Width of the first halo in average distances between the sites
+    static constexpr double HALO_WIDTH = 4.0;
+
+    // nbThreads = 0 uses all the hardware threads, there is one strip per thread. The threads are
+    // started once with the algorithm. stripResources, if not nullptr, holds one resource per strip,
+    // getNbThreads(nbThreads) of them. nullptr takes the memory from the default resource
+    BasicParallelFortuneAlgorithm(unsigned int nbThreads = 0, MemoryResource* resource = nullptr,
+        MemoryResource* const* stripResources = nullptr);
+    BasicParallelFortuneAlgorithm(PointSpan points, unsigned int nbThreads = 0, MemoryResource* resource = nullptr,
+        MemoryResource* const* stripResources = nullptr);
+    ~BasicParallelFortuneAlgorithm();
+
+    // Remove copy operations
+    BasicParallelFortuneAlgorithm(const BasicParallelFortuneAlgorithm&) = delete;
+    BasicParallelFortuneAlgorithm& operator=(const BasicParallelFortuneAlgorithm&) = delete;
+
+    // Start over with new points, they are read in place until the next construct
+    void reset(PointSpan points);
+
+    void construct();
+    bool bound(Box box);
+
+    // Accessors
+    const VoronoiDiagram& getDiagram() const;
+    VoronoiDiagram takeDiagram();
+    // Number of strips of the last construction, 1 if it was a single sweep
+    unsigned int getNbStrips() const;
+
+private:
+    struct Strip
+    {
+        explicit Strip(MemoryResource* resource) : algorithm(resource), coordinates(resource), cells(resource)
+        {
+
+        }
+
+        BasicFortuneAlgorithm<BeachlineType> algorithm;
+        // Buckets of the sites owned by the strip and buckets of the sites swept
+        unsigned int firstBucket;
+        unsigned int lastBucket;
+        unsigned int firstSweptBucket;
+        unsigned int lastSweptBucket;
+        // Buckets whose sites may change the cells, found by the last proof
+        unsigned int firstNeededBucket;
+        unsigned int lastNeededBucket;
+        // Interleaved coordinates and cells of the sites swept
+        IndexPool<double> coordinates;
+        IndexPool<unsigned int> cells;
+        bool isValid;
+    };
+
+    // Bounding box of the sites of a bucket or a block, empty if minX > maxX
+    struct BucketBox
+    {
+        double minX;
+        double minY;
+        double maxX;
+        double maxY;
+    };
+
+    PointSpan mPoints;
+    ThreadPool mThreadPool;
+    MemoryResource* mResource;
+    VoronoiDiagram mDiagram;
+    // Single sweep, from the resource of the algorithm
+    BasicFortuneAlgorithm<BeachlineType> mFallback;
+    // One strip per thread
+    Strip* mStrips;
+    unsigned int mNbAllocatedStrips;
+    unsigned int mNbStrips;
+
+    // The cells are numbered in the order of the sweep, mOrder gives their sites
+    using SiteKey = typename BasicFortuneAlgorithm<BeachlineType>::SiteKey;
+    IndexPool<SiteKey> mSiteKeys;
+    IndexPool<SiteKey> mSiteKeysBuffer;
+    IndexPool<unsigned int> mDigitCounts;
+    IndexPool<unsigned int> mOrder;
+    IndexPool<double> mCoordinates;
+
+    // Buckets
+    unsigned int mNbBuckets;
+    double mMinX;
+    double mBucketScale;
+    unsigned int mHaloBuckets;
+    IndexPool<unsigned int> mCellBuckets;
+    // First and last cells of the buckets, i.e. their highest and lowest sites, they are in all the sweeps
+    IndexPool<unsigned int> mBucketExtremes;
+    // Boxes of the other sites of the buckets and of the blocks
+    IndexPool<BucketBox> mBuckets;
+    IndexPool<BucketBox> mBlocks;
+    // Partial results of the passes over the sites, one array per strip
+    IndexPool<BucketBox> mPartialBoxes;
+    IndexPool<unsigned int> mPartialCounts;
+    IndexPool<unsigned int> mPartialExtremes;
+
+    // Cells of the strips
+    CellStitcher mStitcher;
+
+    void constructWithOneSweep();
+
+    // Partition
+    bool computeBuckets();
+    void sortSites(unsigned int nbChunks);
+    unsigned int getBucket(double x) const;
+
+    // Sweeps
+    void sweepStrip(Strip& strip);
+    bool areCellsProved(Strip& strip) const;
+    bool isCircleEmpty(Strip& strip, const Vector2& center, double squaredRadius) const;
+    bool isHalfPlaneEmpty(Strip& strip, const Vector2& origin, const Vector2& normal) const;
+    void addNeededBucket(Strip& strip, unsigned int bucket) const;
+    static unsigned int getFirstHalfEdge(const VoronoiDiagram& diagram, unsigned int face);
+    bool isOwned(const Strip& strip, unsigned int cell) const;
+
+    // Stitching
+    void copyCells(Strip& strip);
+};
+
+using ParallelFortuneAlgorithm = BasicParallelFortuneAlgorithm<Beachline>;
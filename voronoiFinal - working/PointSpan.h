@@ -0,0 +1,95 @@
+#pragma once
+
+// STL
+#include <cstddef>
+// My includes
+#include "Vector2.h"
+
+// View over points owned by the caller, nothing is copied until the diagram reads them
+// The coordinates are either interleaved (x0, y0, x1, y1, ...) or in two separate arrays,
+// in single or double precision. The stride is counted in coordinates (floats or doubles)
+// between two consecutive points so that arrays of structures can be read in place
+class PointSpan
+{
+public:
+    // Interleaved coordinates, the default stride is for packed xy pairs
+    PointSpan(const double* xy, unsigned int size, unsigned int stride = 2) :
+        mX(xy), mY(xy + 1), mSize(size), mStride(stride), mIsFloat(false)
+    {
+
+    }
+
+    PointSpan(const float* xy, unsigned int size, unsigned int stride = 2) :
+        mX(xy), mY(xy + 1), mSize(size), mStride(stride), mIsFloat(true)
+    {
+
+    }
+
+    // Separate coordinates, the default stride is for packed arrays
+    PointSpan(const double* x, const double* y, unsigned int size, unsigned int stride = 1) :
+        mX(x), mY(y), mSize(size), mStride(stride), mIsFloat(false)
+    {
+
+    }
+
+    PointSpan(const float* x, const float* y, unsigned int size, unsigned int stride = 1) :
+        mX(x), mY(y), mSize(size), mStride(stride), mIsFloat(true)
+    {
+
+    }
+
+    // Accessors
+
+    unsigned int size() const
+    {
+        return mSize;
+    }
+
+    double getX(unsigned int i) const
+    {
+        return read(mX, i);
+    }
+
+    double getY(unsigned int i) const
+    {
+        return read(mY, i);
+    }
+
+    Vector2 operator[](unsigned int i) const
+    {
+        return Vector2(read(mX, i), read(mY, i));
+    }
+
+    // View on the points first to first + size - 1, with the same layout
+    PointSpan getSubspan(unsigned int first, unsigned int size) const
+    {
+        PointSpan span(*this);
+        span.mX = advance(mX, first);
+        span.mY = advance(mY, first);
+        span.mSize = size;
+        return span;
+    }
+
+private:
+    const void* mX;
+    const void* mY;
+    unsigned int mSize;
+    unsigned int mStride;
+    bool mIsFloat;
+
+    const void* advance(const void* coordinates, unsigned int i) const
+    {
+        std::size_t offset = static_cast<std::size_t>(i) * mStride;
+        if (mIsFloat)
+            return static_cast<const float*>(coordinates) + offset;
+        return static_cast<const double*>(coordinates) + offset;
+    }
+
+    double read(const void* coordinates, unsigned int i) const
+    {
+        std::size_t offset = static_cast<std::size_t>(i) * mStride;
+        if (mIsFloat)
+            return static_cast<const float*>(coordinates)[offset];
+        return static_cast<const double*>(coordinates)[offset];
+    }
+};
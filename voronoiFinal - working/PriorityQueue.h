@@ -3,11 +3,16 @@
 #include "Event.h"
 #include "EventVector.h"
 
-
+// Max-heap on Event::y stored contiguously, each event keeps its position in Event::index
 class PriorityQueue
 {
 public:
-	PriorityQueue()
+	// Number of children per node, a 4-ary heap is shallower than a binary one
+	// and the children of a node share a cache line
+	static constexpr unsigned int ARITY = 4;
+
+	// nullptr takes the heap from the default resource
+	explicit PriorityQueue(MemoryResource* resource = nullptr) : mElements(resource)
 	{
 
 	}
@@ -19,13 +24,35 @@ public:
 		return mElements.empty();
 	}
 
+	unsigned int size() const
+	{
+		return mElements.size();
+	}
+
+	Event *top() const
+	{
+		return mElements[0];
+	}
+
 	// Operations
 
+	void reserve(unsigned int capacity)
+	{
+		mElements.reserve(capacity);
+	}
+
+	// Remove all the events but keep the storage
+	void clear()
+	{
+		mElements.clear();
+	}
+
 	Event *pop()
 	{
 		swap(0, mElements.size() - 1);
 		auto top = mElements.pop_back();
-		siftDown(0);
+		if (!mElements.empty())
+			siftDown(0);
 		return top;
 	}
 
@@ -62,52 +89,65 @@ private:
 
 	int getParent(int i) const
 	{
-		return (i + 1) / 2 - 1;
-	}
-
-	unsigned int getLeftChild(unsigned int i) const
-	{
-		return 2 * (i + 1) - 1;
+		return (i - 1) / static_cast<int>(ARITY);
 	}
 
-	unsigned int getRightChild(unsigned int i) const
+	unsigned int getFirstChild(unsigned int i) const
 	{
-		return 2 * (i + 1);
+		return ARITY * i + 1;
 	}
 
 	// Operations
 
 	void siftDown(unsigned int i)
 	{
-		unsigned int left = getLeftChild(i);
-		unsigned int right = getRightChild(i);
-		unsigned int j = i;
-		if (left < mElements.size() && *mElements[j] < *mElements[left])
-			j = left;
-		if (right < mElements.size() && *mElements[j] < *mElements[right])
-			j = right;
-		if (j != i)
+		unsigned int size = mElements.size();
+		Event *elem = mElements.mData[i];
+		while (true)
 		{
-			swap(i, j);
-			siftDown(j);
+			// Find the greatest child
+			unsigned int first = getFirstChild(i);
+			if (first >= size)
+				break;
+			unsigned int last = first + ARITY < size ? first + ARITY : size;
+			unsigned int j = first;
+			for (unsigned int k = first + 1; k < last; ++k)
+			{
+				if (*mElements.mData[j] < *mElements.mData[k])
+					j = k;
+			}
+			if (!(*elem < *mElements.mData[j]))
+				break;
+			// Move the child up and keep looking for the hole
+			place(i, mElements.mData[j]);
+			i = j;
 		}
+		place(i, elem);
 	}
 
 	void siftUp(unsigned int i)
 	{
-		int parent = getParent(i);
-		if (parent >= 0 && *mElements[parent] < *mElements[i])
+		Event *elem = mElements.mData[i];
+		while (i > 0)
 		{
-			swap(i, parent);
-			siftUp(parent);
+			unsigned int parent = getParent(i);
+			if (!(*mElements.mData[parent] < *elem))
+				break;
+			// Move the parent down and keep looking for the hole
+			place(i, mElements.mData[parent]);
+			i = parent;
 		}
+		place(i, elem);
 	}
 
+	inline void place(unsigned int i, Event *elem)
+	{
+		mElements.mData[i] = elem;
+		elem->index = i;
+	}
 
 	inline void swap(unsigned int i, unsigned int j)
 	{
 		mElements.swap(i,j);
 	}
 };
-
-
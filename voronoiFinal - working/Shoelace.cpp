@@ -0,0 +1,176 @@
+#include "Shoelace.h"
+// STL
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SHOELACE_SSE2
+#include <emmintrin.h>
+#endif
+
+// The AVX kernel is compiled for any x86 target and only called if the CPU supports it
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define SHOELACE_AVX
+#define SHOELACE_AVX_TARGET
+#include <immintrin.h>
+#include <intrin.h>
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SHOELACE_AVX
+#define SHOELACE_AVX_TARGET __attribute__((target("avx")))
+#include <immintrin.h>
+#endif
+
+// Adds the edges (i, i + 1) for i in [begin, n - 1) and the closing edge (n - 1, 0)
+static void addEdges(const double* x, const double* y, unsigned int begin, unsigned int n, PolygonMeasures& measures)
+{
+    for (unsigned int i = begin; i < n; ++i)
+    {
+        unsigned int j = i + 1 < n ? i + 1 : 0;
+        double a = x[i] * y[j] - x[j] * y[i];
+        measures.doubleArea += a;
+        measures.momentX += (x[i] + x[j]) * a;
+        measures.momentY += (y[i] + y[j]) * a;
+        double dx = x[j] - x[i];
+        double dy = y[j] - y[i];
+        measures.perimeter += std::sqrt(dx * dx + dy * dy);
+    }
+}
+
+#ifndef SHOELACE_SSE2
+static PolygonMeasures computeScalar(const double* x, const double* y, unsigned int n)
+{
+    PolygonMeasures measures = {0.0, 0.0, 0.0, 0.0};
+    addEdges(x, y, 0, n, measures);
+    return measures;
+}
+#endif
+
+#ifdef SHOELACE_SSE2
+// Two edges per iteration, the edges that do not fill a register are added by addEdges
+static PolygonMeasures computeSse2(const double* x, const double* y, unsigned int n)
+{
+    __m128d area = _mm_setzero_pd();
+    __m128d momentX = _mm_setzero_pd();
+    __m128d momentY = _mm_setzero_pd();
+    __m128d perimeter = _mm_setzero_pd();
+    unsigned int i = 0;
+    for (; i + 2 < n; i += 2)
+    {
+        __m128d x0 = _mm_loadu_pd(x + i);
+        __m128d y0 = _mm_loadu_pd(y + i);
+        __m128d x1 = _mm_loadu_pd(x + i + 1);
+        __m128d y1 = _mm_loadu_pd(y + i + 1);
+        __m128d a = _mm_sub_pd(_mm_mul_pd(x0, y1), _mm_mul_pd(x1, y0));
+        area = _mm_add_pd(area, a);
+        momentX = _mm_add_pd(momentX, _mm_mul_pd(_mm_add_pd(x0, x1), a));
+        momentY = _mm_add_pd(momentY, _mm_mul_pd(_mm_add_pd(y0, y1), a));
+        __m128d dx = _mm_sub_pd(x1, x0);
+        __m128d dy = _mm_sub_pd(y1, y0);
+        perimeter = _mm_add_pd(perimeter, _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy))));
+    }
+    double lanes[2];
+    PolygonMeasures measures;
+    _mm_storeu_pd(lanes, area);
+    measures.doubleArea = lanes[0] + lanes[1];
+    _mm_storeu_pd(lanes, momentX);
+    measures.momentX = lanes[0] + lanes[1];
+    _mm_storeu_pd(lanes, momentY);
+    measures.momentY = lanes[0] + lanes[1];
+    _mm_storeu_pd(lanes, perimeter);
+    measures.perimeter = lanes[0] + lanes[1];
+    addEdges(x, y, i, n, measures);
+    return measures;
+}
+#endif
+
+#ifdef SHOELACE_AVX
+static SHOELACE_AVX_TARGET double sumLanes(__m256d v)
+{
+    __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    double lanes[2];
+    _mm_storeu_pd(lanes, sum);
+    return lanes[0] + lanes[1];
+}
+
+// Four edges per iteration, same layout as computeSse2
+static SHOELACE_AVX_TARGET PolygonMeasures computeAvx(const double* x, const double* y, unsigned int n)
+{
+    __m256d area = _mm256_setzero_pd();
+    __m256d momentX = _mm256_setzero_pd();
+    __m256d momentY = _mm256_setzero_pd();
+    __m256d perimeter = _mm256_setzero_pd();
+    unsigned int i = 0;
+    for (; i + 4 < n; i += 4)
+    {
+        __m256d x0 = _mm256_loadu_pd(x + i);
+        __m256d y0 = _mm256_loadu_pd(y + i);
+        __m256d x1 = _mm256_loadu_pd(x + i + 1);
+        __m256d y1 = _mm256_loadu_pd(y + i + 1);
+        __m256d a = _mm256_sub_pd(_mm256_mul_pd(x0, y1), _mm256_mul_pd(x1, y0));
+        area = _mm256_add_pd(area, a);
+        momentX = _mm256_add_pd(momentX, _mm256_mul_pd(_mm256_add_pd(x0, x1), a));
+        momentY = _mm256_add_pd(momentY, _mm256_mul_pd(_mm256_add_pd(y0, y1), a));
+        __m256d dx = _mm256_sub_pd(x1, x0);
+        __m256d dy = _mm256_sub_pd(y1, y0);
+        perimeter = _mm256_add_pd(perimeter, _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy))));
+    }
+    PolygonMeasures measures;
+    measures.doubleArea = sumLanes(area);
+    measures.momentX = sumLanes(momentX);
+    measures.momentY = sumLanes(momentY);
+    measures.perimeter = sumLanes(perimeter);
+    addEdges(x, y, i, n, measures);
+    return measures;
+}
+
+static bool hasAvx()
+{
+#if defined(_MSC_VER)
+    // The CPU must support AVX and the OS must save the ymm registers
+    int info[4];
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    return osxsave && avx && (_xgetbv(0) & 6) == 6;
+#else
+    return __builtin_cpu_supports("avx");
+#endif
+}
+#endif
+
+typedef PolygonMeasures (*ShoelaceKernel)(const double* x, const double* y, unsigned int n);
+
+struct ShoelaceDispatch
+{
+    ShoelaceKernel kernel;
+    const char* name;
+};
+
+static ShoelaceDispatch selectKernel()
+{
+#ifdef SHOELACE_AVX
+    if (hasAvx())
+        return ShoelaceDispatch{computeAvx, "avx"};
+#endif
+#ifdef SHOELACE_SSE2
+    return ShoelaceDispatch{computeSse2, "sse2"};
+#else
+    return ShoelaceDispatch{computeScalar, "scalar"};
+#endif
+}
+
+// Selected at the first call
+static const ShoelaceDispatch& getDispatch()
+{
+    static const ShoelaceDispatch dispatch = selectKernel();
+    return dispatch;
+}
+
+PolygonMeasures computePolygonMeasures(const double* x, const double* y, unsigned int n)
+{
+    return getDispatch().kernel(x, y, n);
+}
+
+const char* getShoelaceKernelName()
+{
+    return getDispatch().name;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+// Sums of the shoelace formula over the edges of a closed polygon
+// area = doubleArea / 2 and centroid = (momentX, momentY) / (3 * doubleArea)
+struct PolygonMeasures
+{
+    double doubleArea;
+    double momentX;
+    double momentY;
+    double perimeter;
+};
+
+// The n vertices are given as packed coordinates, the last one is linked to the first. The kernel
+// is only useful to callers that already hold packed polygons: no code path of the library packs
+// the faces of a diagram for it, VoronoiDiagram walks their half edges in place.
+// The kernel is picked once at runtime among AVX, SSE2 and scalar depending on the CPU,
+// the vector kernels add the edges in another order so the last bits may differ.
+PolygonMeasures computePolygonMeasures(const double* x, const double* y, unsigned int n);
+
+// Name of the kernel picked for this CPU
+const char* getShoelaceKernelName();
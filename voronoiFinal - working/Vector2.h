@@ -3,44 +3,112 @@
 // Declarations
 
 class Vector2;
-Vector2 operator-(Vector2 lhs, const Vector2& rhs);
+constexpr Vector2 operator-(Vector2 lhs, const Vector2& rhs);
 
 // Implementations
 
+// Plain 16-byte value, containers keep their own bookkeeping next to it
 class Vector2
 {
 public:
     double x;
     double y;
 
-	// Used in Vector2Vector
-	int index;
-	Vector2* next = nullptr;
+    constexpr Vector2(double x = 0.0, double y = 0.0) : x(x), y(y)
+    {
 
-    Vector2(double x = 0.0, double y = 0.0);
+    }
 
     // Unary operators
 
-    Vector2 operator-() const;
-    Vector2& operator+=(const Vector2& other);
-    Vector2& operator-=(const Vector2& other);
-    Vector2& operator*=(double t);
-	bool operator==(const Vector2& other);
+    constexpr Vector2 operator-() const
+    {
+        return Vector2(-x, -y);
+    }
+
+    constexpr Vector2& operator+=(const Vector2& other)
+    {
+        x += other.x;
+        y += other.y;
+        return *this;
+    }
+
+    constexpr Vector2& operator-=(const Vector2& other)
+    {
+        x -= other.x;
+        y -= other.y;
+        return *this;
+    }
+
+    constexpr Vector2& operator*=(double t)
+    {
+        x *= t;
+        y *= t;
+        return *this;
+    }
+
+    constexpr bool operator==(const Vector2& other) const
+    {
+        return x == other.x && y == other.y;
+    }
     
     // Other operations
     
-    Vector2 getOrthogonal() const;
-    double dot(const Vector2& other) const;
+    constexpr Vector2 getOrthogonal() const
+    {
+        return Vector2(-y, x);
+    }
+
+    constexpr double dot(const Vector2& other) const
+    {
+        return x * other.x + y * other.y;
+    }
+
     double getNorm() const;
+
+    // Prefer the squared norm when only the order matters
+    constexpr double getSquaredNorm() const
+    {
+        return x * x + y * y;
+    }
+
     double getDistance(const Vector2& other) const;
-    double getDet(const Vector2& other) const;
-	double squareRoot(double n) const;
+
+    constexpr double getSquaredDistance(const Vector2& other) const
+    {
+        return (x - other.x) * (x - other.x) + (y - other.y) * (y - other.y);
+    }
+
+    constexpr double getDet(const Vector2& other) const
+    {
+        return x * other.y - y * other.x;
+    }
 };
 
+static_assert(sizeof(Vector2) == 2 * sizeof(double), "Vector2 must stay two doubles");
+
 // Binary operators
 
-Vector2 operator+(Vector2 lhs, const Vector2& rhs);
-Vector2 operator-(Vector2 lhs, const Vector2& rhs);
-Vector2 operator*(double t, Vector2 vec);
-Vector2 operator*(Vector2 vec, double t);
+constexpr Vector2 operator+(Vector2 lhs, const Vector2& rhs)
+{
+    lhs += rhs;
+    return lhs;
+}
+
+constexpr Vector2 operator-(Vector2 lhs, const Vector2& rhs)
+{
+    lhs -= rhs;
+    return lhs;
+}
+
+constexpr Vector2 operator*(double t, Vector2 vec)
+{
+    vec *= t;
+    return vec;
+}
+
+constexpr Vector2 operator*(Vector2 vec, double t)
+{
+    return t * vec;
+}
 
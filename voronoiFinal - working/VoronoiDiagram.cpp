@@ -1,18 +1,67 @@
 #include "VoronoiDiagram.h"
+// My includes
+#include "ParallelFor.h"
 
-VoronoiDiagram::VoronoiDiagram(Vector2Vector points)
+VoronoiDiagram::VoronoiDiagram(MemoryResource* resource) :
+    mSites(resource), mFaces(resource), mVertices(resource), mHalfEdges(resource), mHalfEdgeEpochs(resource),
+    mVerticesToRemove(resource), mNewVertexIndices(resource), mLinkedVertices(resource), mBoundaryCells(resource), mBoundaryCellOfSite(resource)
 {
-    for(unsigned int i = 0; i < points.size(); ++i)
+
+}
+
+VoronoiDiagram::VoronoiDiagram(const Vector2Vector& points, MemoryResource* resource) : VoronoiDiagram(resource)
+{
+    reset(points);
+}
+
+VoronoiDiagram::VoronoiDiagram(PointSpan points, MemoryResource* resource) : VoronoiDiagram(resource)
+{
+    reset(points);
+}
+
+void VoronoiDiagram::reset(const Vector2Vector& points)
+{
+    unsigned int nbSites = points.size();
+    clear(nbSites);
+    for (unsigned int i = 0; i < nbSites; ++i)
     {
-        mSites.push_back(new VoronoiDiagram::Site{i, points[i], nullptr});
-        mFaces.push_back(new VoronoiDiagram::Face{mSites.back(), nullptr});
-        mSites.back()->face = mFaces.back();
+        mSites.push_back(VoronoiDiagram::Site{i, points[i], i});
+        mFaces.push_back(VoronoiDiagram::Face{i, NONE});
     }
 }
 
+void VoronoiDiagram::reset(PointSpan points)
+{
+    unsigned int nbSites = points.size();
+    clear(nbSites);
+    for (unsigned int i = 0; i < nbSites; ++i)
+    {
+        mSites.push_back(VoronoiDiagram::Site{i, points[i], i});
+        mFaces.push_back(VoronoiDiagram::Face{i, NONE});
+    }
+}
+
+void VoronoiDiagram::clear(unsigned int nbSites)
+{
+    mSites.clear();
+    mFaces.clear();
+    mVertices.clear();
+    mHalfEdges.clear();
+    mSites.reserve(nbSites);
+    mFaces.reserve(nbSites);
+    // A diagram of n sites has at most 2n - 5 vertices and 3n - 6 edges before bounding
+    mVertices.reserve(2 * nbSites);
+    mHalfEdges.reserve(6 * nbSites);
+}
+
 VoronoiDiagram::Site* VoronoiDiagram::getSite(unsigned int i)
 {
-    return mSites[i];
+    return &mSites[i];
+}
+
+const VoronoiDiagram::Site* VoronoiDiagram::getSite(unsigned int i) const
+{
+    return &mSites[i];
 }
 
 unsigned int VoronoiDiagram::getNbSites() const
@@ -22,68 +71,226 @@ unsigned int VoronoiDiagram::getNbSites() const
 
 VoronoiDiagram::Face* VoronoiDiagram::getFace(unsigned int i)
 {
-    return mFaces[i];
+    return &mFaces[i];
+}
+
+const VoronoiDiagram::Face* VoronoiDiagram::getFace(unsigned int i) const
+{
+    return &mFaces[i];
+}
+
+VoronoiDiagram::Vertex* VoronoiDiagram::getVertex(unsigned int i)
+{
+    return &mVertices[i];
+}
+
+const VoronoiDiagram::Vertex* VoronoiDiagram::getVertex(unsigned int i) const
+{
+    return &mVertices[i];
 }
 
-const VoronoiDiagram::VertexList VoronoiDiagram::getVertices() const
+VoronoiDiagram::HalfEdge* VoronoiDiagram::getHalfEdge(unsigned int i)
+{
+    return &mHalfEdges[i];
+}
+
+const VoronoiDiagram::HalfEdge* VoronoiDiagram::getHalfEdge(unsigned int i) const
+{
+    return &mHalfEdges[i];
+}
+
+const IndexPool<VoronoiDiagram::Vertex>& VoronoiDiagram::getVertices() const
 {
     return mVertices;
 }
 
+const IndexPool<VoronoiDiagram::HalfEdge>& VoronoiDiagram::getHalfEdges() const
+{
+    return mHalfEdges;
+}
+
+MemoryResource* VoronoiDiagram::getMemoryResource() const
+{
+    return mSites.getMemoryResource();
+}
+
+
+bool VoronoiDiagram::bound(Box box)
+{
+    // Make sure the bounding box contains all the vertices
+    for (unsigned int i = 0; i < mVertices.size(); ++i)
+    {
+        const Vector2& point = mVertices[i].point;
+        box.left = point.x < box.left ? point.x : box.left;
+        box.bottom = point.y < box.bottom ? point.y : box.bottom;
+        box.right = point.x > box.right ? point.x : box.right;
+        box.top = point.y > box.top ? point.y : box.top;
+    }
+    // Only the cells with infinite edges touch the box
+    mLinkedVertices.clear();
+    mBoundaryCells.clear();
+    mBoundaryCellOfSite.clear();
+    mBoundaryCellOfSite.resize(mSites.size());
+    for (unsigned int i = 0; i < mBoundaryCellOfSite.size(); ++i)
+        mBoundaryCellOfSite[i] = NONE;
+    // An infinite edge starts at infinity in the cell on its left, the vertices created
+    // here are origins so the half edges added below are not visited
+    unsigned int nbHalfEdges = mHalfEdges.size();
+    for (unsigned int i = 0; i < nbHalfEdges; ++i)
+    {
+        if (mHalfEdges[i].origin != NONE || mHalfEdges[i].incidentFace == NONE)
+            continue;
+        unsigned int twin = getTwin(i);
+        unsigned int leftSite = mFaces[mHalfEdges[i].incidentFace].site;
+        unsigned int rightSite = mFaces[mHalfEdges[twin].incidentFace].site;
+        // Bound the edge
+        Vector2 direction = (mSites[leftSite].point - mSites[rightSite].point).getOrthogonal();
+        Vector2 origin = (mSites[leftSite].point + mSites[rightSite].point) * 0.5f;
+        // Line-box intersection
+        Box::Intersection intersection = box.getFirstIntersection(origin, direction);
+        // Create a new vertex and ends the half edges
+        unsigned int vertex = createVertex(intersection.point);
+        mHalfEdges[i].origin = vertex;
+        mHalfEdges[twin].destination = vertex;
+        // Store the vertex on the boundaries
+        unsigned int side = static_cast<unsigned int>(intersection.side);
+        getBoundaryCell(leftSite).slots[2 * side + 1] = addLinkedVertex(NONE, vertex, i);
+        getBoundaryCell(rightSite).slots[2 * side] = addLinkedVertex(twin, vertex, NONE);
+    }
+    // Add corners
+    for (unsigned int i = 0; i < mBoundaryCells.size(); ++i)
+    {
+        unsigned int* slots = mBoundaryCells[i].slots;
+        // We check twice the first side to be sure that all necessary corners are added
+        for (unsigned int j = 0; j < 5; ++j)
+        {
+            unsigned int side = j % 4;
+            unsigned int nextSide = (side + 1) % 4;
+            // Add first corner
+            if (slots[2 * side] == NONE && slots[2 * side + 1] != NONE)
+            {
+                unsigned int prevSide = (side + 3) % 4;
+                unsigned int corner = createCorner(box, static_cast<Box::Side>(side));
+                unsigned int linkedVertex = addLinkedVertex(NONE, corner, NONE);
+                slots[2 * prevSide + 1] = linkedVertex;
+                slots[2 * side] = linkedVertex;
+            }
+            // Add second corner
+            else if (slots[2 * side] != NONE && slots[2 * side + 1] == NONE)
+            {
+                unsigned int corner = createCorner(box, static_cast<Box::Side>(nextSide));
+                unsigned int linkedVertex = addLinkedVertex(NONE, corner, NONE);
+                slots[2 * side + 1] = linkedVertex;
+                slots[2 * nextSide] = linkedVertex;
+            }
+        }
+    }
+    // Join the half edges
+    for (unsigned int i = 0; i < mBoundaryCells.size(); ++i)
+    {
+        const LinkedVertexArray& cell = mBoundaryCells[i];
+        for (unsigned int side = 0; side < 4; ++side)
+        {
+            if (cell.slots[2 * side] == NONE)
+                continue;
+            // Link the first and the last vertices on this side
+            LinkedVertex& first = mLinkedVertices[cell.slots[2 * side]];
+            LinkedVertex& last = mLinkedVertices[cell.slots[2 * side + 1]];
+            unsigned int halfEdge = createHalfEdge(mSites[cell.site].face);
+            HalfEdge& boundary = mHalfEdges[halfEdge];
+            boundary.origin = first.vertex;
+            boundary.destination = last.vertex;
+            first.nextHalfEdge = halfEdge;
+            boundary.prev = first.prevHalfEdge;
+            if (first.prevHalfEdge != NONE)
+                mHalfEdges[first.prevHalfEdge].next = halfEdge;
+            last.prevHalfEdge = halfEdge;
+            boundary.next = last.nextHalfEdge;
+            if (last.nextHalfEdge != NONE)
+                mHalfEdges[last.nextHalfEdge].prev = halfEdge;
+        }
+    }
+    return true;
+}
+
+LinkedVertexArray& VoronoiDiagram::getBoundaryCell(unsigned int site)
+{
+    if (mBoundaryCellOfSite[site] == NONE)
+    {
+        mBoundaryCellOfSite[site] = mBoundaryCells.allocate(1);
+        LinkedVertexArray& cell = mBoundaryCells.back();
+        cell.site = site;
+        for (unsigned int i = 0; i < 8; ++i)
+            cell.slots[i] = NONE;
+    }
+    return mBoundaryCells[mBoundaryCellOfSite[site]];
+}
+
+unsigned int VoronoiDiagram::addLinkedVertex(unsigned int prevHalfEdge, unsigned int vertex, unsigned int nextHalfEdge)
+{
+    return mLinkedVertices.push_back(LinkedVertex{prevHalfEdge, vertex, nextHalfEdge});
+}
 
 bool VoronoiDiagram::intersect(Box box)
 {
     bool error = false;
-    HalfEdgeUnorderedSet processedHalfEdges;
-    VertexUnorderedSet verticesToRemove;
-    for (int i = 0; i < mSites.size(); i++)
+    startClipping();
+    for (unsigned int i = 0; i < mSites.size(); i++)
     {
-		Site site = *mSites[i];
-        HalfEdge* halfEdge = site.face->outerComponent;
-        bool inside = box.contains(halfEdge->origin->point);
+        unsigned int face = mSites[i].face;
+        unsigned int halfEdge = mFaces[face].outerComponent;
+        bool inside = box.contains(mVertices[mHalfEdges[halfEdge].origin].point);
         bool outerComponentDirty = !inside;
-        HalfEdge* incomingHalfEdge = nullptr; // First half edge coming in the box
-        HalfEdge* outgoingHalfEdge = nullptr; // Last half edge going out the box
-        Box::Side incomingSide, outgoingSide;
+        unsigned int incomingHalfEdge = NONE; // First half edge coming in the box
+        unsigned int outgoingHalfEdge = NONE; // Last half edge going out the box
+        Box::Side incomingSide = Box::Side::LEFT;
+        Box::Side outgoingSide = Box::Side::LEFT;
 		
         do
         {
-			int nbIntersections = box.getIntersections(halfEdge->origin->point, halfEdge->destination->point, intersections);			
-            bool nextInside = box.contains(halfEdge->destination->point);
-            HalfEdge* nextHalfEdge = halfEdge->next;
+            unsigned int origin = mHalfEdges[halfEdge].origin;
+            unsigned int destination = mHalfEdges[halfEdge].destination;
+            unsigned int twin = getTwin(halfEdge);
+            bool nextInside = box.contains(mVertices[destination].point);
+            // An edge inside the box is kept as is
+            int nbIntersections = inside && nextInside ? 0 :
+                box.getIntersections(mVertices[origin].point, mVertices[destination].point, intersections);
+            unsigned int nextHalfEdge = mHalfEdges[halfEdge].next;
             // The two points are outside the box 
             if (!inside && !nextInside)
             {
                 // The edge is outside the box
                 if (nbIntersections == 0)
                 {
-                    verticesToRemove.emplace(halfEdge->origin);
+                    markForRemoval(origin);
                     removeHalfEdge(halfEdge);
                 }
                 // The edge crosses twice the frontiers of the box
                 else if (nbIntersections == 2)
                 {
-                    verticesToRemove.emplace(halfEdge->origin);
-                    if (processedHalfEdges.find(halfEdge->twin))
+                    markForRemoval(origin);
+                    if (isProcessed(twin))
                     {
-                        halfEdge->origin = halfEdge->twin->destination;
-                        halfEdge->destination = halfEdge->twin->origin;
+                        origin = mHalfEdges[twin].destination;
+                        destination = mHalfEdges[twin].origin;
                     }
                     else
                     {
-                        halfEdge->origin = createVertex(intersections[0]->point);
-                        halfEdge->destination = createVertex(intersections[1]->point);
+                        origin = createVertex(intersections[0]->point);
+                        destination = createVertex(intersections[1]->point);
                     }
-                    if (outgoingHalfEdge != nullptr)
+                    mHalfEdges[halfEdge].origin = origin;
+                    mHalfEdges[halfEdge].destination = destination;
+                    if (outgoingHalfEdge != NONE)
                         link(box, outgoingHalfEdge, outgoingSide, halfEdge, intersections[0]->side);
-                    if (incomingHalfEdge == nullptr)
+                    if (incomingHalfEdge == NONE)
                     {
                        incomingHalfEdge = halfEdge;
                        incomingSide = intersections[0]->side;
                     }
                     outgoingHalfEdge = halfEdge;
                     outgoingSide = intersections[1]->side;
-                    processedHalfEdges.emplace(halfEdge);
+                    setProcessed(halfEdge);
                 }
                 else
                     error = true;
@@ -93,13 +300,14 @@ bool VoronoiDiagram::intersect(Box box)
             {
                 if (nbIntersections == 1)
                 {
-                    if (processedHalfEdges.find(halfEdge->twin))
-                        halfEdge->destination = halfEdge->twin->origin;
+                    if (isProcessed(twin))
+                        destination = mHalfEdges[twin].origin;
                     else
-                        halfEdge->destination = createVertex(intersections[0]->point);
+                        destination = createVertex(intersections[0]->point);
+                    mHalfEdges[halfEdge].destination = destination;
                     outgoingHalfEdge = halfEdge;
                     outgoingSide = intersections[0]->side;
-                    processedHalfEdges.emplace(halfEdge);
+                    setProcessed(halfEdge);
                 }
                 else
                     error = true;
@@ -109,19 +317,20 @@ bool VoronoiDiagram::intersect(Box box)
             {
                 if (nbIntersections == 1)
                 {
-                    verticesToRemove.emplace(halfEdge->origin);
-                    if (processedHalfEdges.find(halfEdge->twin))
-                        halfEdge->origin = halfEdge->twin->destination;
+                    markForRemoval(origin);
+                    if (isProcessed(twin))
+                        origin = mHalfEdges[twin].destination;
                     else
-                        halfEdge->origin = createVertex(intersections[0]->point);
-                    if (outgoingHalfEdge != nullptr)
+                        origin = createVertex(intersections[0]->point);
+                    mHalfEdges[halfEdge].origin = origin;
+                    if (outgoingHalfEdge != NONE)
                         link(box, outgoingHalfEdge, outgoingSide, halfEdge, intersections[0]->side);
-                    if (incomingHalfEdge == nullptr)
+                    if (incomingHalfEdge == NONE)
                     {
                        incomingHalfEdge = halfEdge;
                        incomingSide = intersections[0]->side;
                     }
-                    processedHalfEdges.emplace(halfEdge);
+                    setProcessed(halfEdge);
                 }
                 else
                     error = true;
@@ -129,34 +338,34 @@ bool VoronoiDiagram::intersect(Box box)
             halfEdge = nextHalfEdge;
             // Update inside
             inside = nextInside;
-        } while (halfEdge != site.face->outerComponent);
-        // Link the last and the first half edges inside the box
-        if (outerComponentDirty && incomingHalfEdge != nullptr)
-            link(box, outgoingHalfEdge, outgoingSide, incomingHalfEdge, incomingSide);
+        } while (halfEdge != mFaces[face].outerComponent);
+        // Link the last and the first half edges inside the box, there is no last one when a vertex
+        // on the frontier of the box hid an intersection
+        if (outerComponentDirty && incomingHalfEdge != NONE)
+        {
+            if (outgoingHalfEdge != NONE)
+                link(box, outgoingHalfEdge, outgoingSide, incomingHalfEdge, incomingSide);
+            else
+                error = true;
+        }
         // Set outer component
         if (outerComponentDirty)
-            site.face->outerComponent = incomingHalfEdge;
+            mFaces[face].outerComponent = incomingHalfEdge;
     }
 
-
-	for (int i = 0; i < verticesToRemove.mSize-1; i++) {
-		Vertex* v = verticesToRemove.pop();
-		if (v == nullptr) continue;
-		removeVertex(v);
-	}
+    removeVertices();
     // Return the status
     return !error;
 }
 
-VoronoiDiagram::Vertex* VoronoiDiagram::createVertex(Vector2 point)
+unsigned int VoronoiDiagram::createVertex(Vector2 point)
 {
-	Vertex* v = new Vertex();
-	v->point = point;
-	mVertices.emplace_back(v);
-	return mVertices.back();
+	unsigned int vertex = mVertices.allocate(1);
+	mVertices[vertex].point = point;
+	return vertex;
 }
 
-VoronoiDiagram::Vertex* VoronoiDiagram::createCorner(Box box, Box::Side side)
+unsigned int VoronoiDiagram::createCorner(Box box, Box::Side side)
 {
     switch (side)
     {
@@ -169,442 +378,225 @@ VoronoiDiagram::Vertex* VoronoiDiagram::createCorner(Box box, Box::Side side)
         case Box::Side::TOP:
             return createVertex(Vector2(box.right, box.top));
         default:
-            return nullptr;
+            return NONE;
     }
 }
 
-VoronoiDiagram::HalfEdge* VoronoiDiagram::createHalfEdge(Face* face)
+unsigned int VoronoiDiagram::createEdge(unsigned int leftFace, unsigned int rightFace)
 {
-	HalfEdge *h = new HalfEdge();
-	h->incidentFace = face;
-    mHalfEdges.emplace_back(h);
-    if(face->outerComponent == nullptr)
-        face->outerComponent = mHalfEdges.back();
-    return mHalfEdges.back();
+    // The twin of the returned half edge is the next one in the pool
+    unsigned int halfEdge = mHalfEdges.allocate(2);
+    mHalfEdges[halfEdge].incidentFace = leftFace;
+    mHalfEdges[halfEdge + 1].incidentFace = rightFace;
+    if (mFaces[leftFace].outerComponent == NONE)
+        mFaces[leftFace].outerComponent = halfEdge;
+    if (mFaces[rightFace].outerComponent == NONE)
+        mFaces[rightFace].outerComponent = halfEdge + 1;
+    return halfEdge;
+}
+
+unsigned int VoronoiDiagram::createHalfEdge(unsigned int face)
+{
+    // Half edges without twin still take a pair so that getTwin stays arithmetic
+	unsigned int halfEdge = mHalfEdges.allocate(2);
+	mHalfEdges[halfEdge].incidentFace = face;
+    if (mFaces[face].outerComponent == NONE)
+        mFaces[face].outerComponent = halfEdge;
+    return halfEdge;
 }
 
-void VoronoiDiagram::link(Box box, HalfEdge* start, Box::Side startSide, HalfEdge* end, Box::Side endSide)
+void VoronoiDiagram::link(Box box, unsigned int start, Box::Side startSide, unsigned int end, Box::Side endSide)
 {
-    HalfEdge* halfEdge = start;
+    unsigned int halfEdge = start;
+    unsigned int face = mHalfEdges[start].incidentFace;
     int side = static_cast<int>(startSide);
     while (side != static_cast<int>(endSide))
     {
         side = (side + 1) % 4;
-        halfEdge->next = createHalfEdge(start->incidentFace);
-        halfEdge->next->prev = halfEdge;
-        halfEdge->next->origin = halfEdge->destination;
-        halfEdge->next->destination = createCorner(box, static_cast<Box::Side>(side));
-        halfEdge = halfEdge->next;
+        unsigned int next = createHalfEdge(face);
+        unsigned int corner = createCorner(box, static_cast<Box::Side>(side));
+        mHalfEdges[halfEdge].next = next;
+        mHalfEdges[next].prev = halfEdge;
+        mHalfEdges[next].origin = mHalfEdges[halfEdge].destination;
+        mHalfEdges[next].destination = corner;
+        halfEdge = next;
     }
-    halfEdge->next = createHalfEdge(start->incidentFace);
-    halfEdge->next->prev = halfEdge;
-    end->prev = halfEdge->next;
-    halfEdge->next->next = end;
-    halfEdge->next->origin = halfEdge->destination;
-    halfEdge->next->destination = end->origin;
+    unsigned int next = createHalfEdge(face);
+    mHalfEdges[halfEdge].next = next;
+    mHalfEdges[next].prev = halfEdge;
+    mHalfEdges[end].prev = next;
+    mHalfEdges[next].next = end;
+    mHalfEdges[next].origin = mHalfEdges[halfEdge].destination;
+    mHalfEdges[next].destination = mHalfEdges[end].origin;
 }
 
-void VoronoiDiagram::removeVertex(Vertex* vertex)
+void VoronoiDiagram::startClipping()
 {
-	mVertices.erase(vertex);
+    // Restart the stamps when the epoch wraps around
+    if (++mEpoch == 0)
+    {
+        for (unsigned int i = 0; i < mHalfEdgeEpochs.size(); ++i)
+            mHalfEdgeEpochs[i] = 0;
+        mEpoch = 1;
+    }
+    if (mHalfEdgeEpochs.size() < mHalfEdges.size())
+        mHalfEdgeEpochs.resize(mHalfEdges.size());
+    // The vertices created while clipping are never removed
+    mVerticesToRemove.clear();
+    mVerticesToRemove.resize((mVertices.size() + 31) / 32);
 }
 
-void VoronoiDiagram::removeHalfEdge(HalfEdge* halfEdge)
+bool VoronoiDiagram::isProcessed(unsigned int halfEdge) const
 {
-    mHalfEdges.erase(halfEdge);
-}
-
-
-// Algorithms for finding centroids
-
-Vector2Vector VoronoiDiagram::getFaceVertex(Face f) {
-	Vector2Vector myVertices;
-	HalfEdge *startingEdge = f.outerComponent;
-	myVertices.push_back(new Vector2{ f.outerComponent->origin->point.x, f.outerComponent->origin->point.y });		// Push outercomponent's starting vertex
-
-	// Push all other edge's starting vertexs
-	HalfEdge *tmp = startingEdge->next;
-	while (tmp != startingEdge) {
-		myVertices.push_back(new Vector2{ tmp->origin->point.x, tmp->origin->point.y });
-		tmp = tmp->next;
-	}
-
-	return myVertices;
-}
-
-Vector2* VoronoiDiagram::getCentroid(Vector2Vector myVertices) {
-	Vector2* centroid = new Vector2{ 0, 0 };
-	double signedArea = 0.0;
-	double x0 = 0.0; // Current vertex X
-	double y0 = 0.0; // Current vertex Y
-	double x1 = 0.0; // Next vertex X
-	double y1 = 0.0; // Next vertex Y
-	double a = 0.0;  // Partial signed area
-
-	// For all vertices
-	int i = 0;
-	for (i = 0; i < myVertices.size(); ++i)
-	{
-		x0 = myVertices[i].x;
-		y0 = myVertices[i].y;
-		x1 = myVertices[(i + 1) % myVertices.size()].x;
-		y1 = myVertices[(i + 1) % myVertices.size()].y;
-		a = x0 * y1 - x1 * y0;
-		signedArea += a;
-		centroid->x += (x0 + x1)*a;
-		centroid->y += (y0 + y1)*a;
-	}
-
-	signedArea *= 0.5;
-	centroid->x /= (6.0*signedArea);
-	centroid->y /= (6.0*signedArea);
-
-	return centroid;
-}
-
- Vector2Vector VoronoiDiagram::getCentroids() {
-	 Vector2Vector centroids;
-	 for (unsigned int i = 0; i < mFaces.mSize; ++i) {
-		 centroids.push_back(getCentroid(getFaceVertex(*mFaces[i])));
-	 }
-	 return centroids;
- }
-
-// Site Vector
-
-VoronoiDiagram::SiteVector::SiteVector() {
-	head = nullptr;
-	tail = nullptr;
-}
-
-void VoronoiDiagram::SiteVector::push_back(Site* e) {
-	Site *tmp = head;
-	e->next = nullptr;
-
-	if (head == nullptr)			// If list is empty make Site e the head
-	{
-		head = e;
-		tail = e;
-		mSize++;
-		return;
-	}
-
-	while (tmp->next != nullptr)		// Else traverse list until the last node
-		tmp = tmp->next;
-
-	tmp->next = e;					// Set tail's next as e
-	tail = e;						// Set e as new tail
-	mSize++;
-	return;
-}
-
-VoronoiDiagram::Site* VoronoiDiagram::SiteVector::back() {
-	return tail;
-}
-
-const unsigned int VoronoiDiagram::SiteVector::size() const {
-	return mSize;
-}
-
-VoronoiDiagram::Site* VoronoiDiagram::SiteVector::operator[](unsigned int index) {
-	if (index > mSize) {
-		return nullptr;					// If index is out of bounds return null
-	}
-	Site* tmp = head;
-	while (tmp->index != index) {
-		tmp = tmp->next;
-	}
-	return tmp;
-}
-
-// VertexUnorderedSet
-
-VoronoiDiagram::VertexUnorderedSet::VertexUnorderedSet() {
-	head = nullptr;
-	mSize = 0;
-}
-
-// Traverse through the set, if no vertex in the unordered set matches e, then put e at the end of the set.
-// Only inserts element if the value is unique within the set
-void VoronoiDiagram::VertexUnorderedSet::emplace(Vertex* e) {
-	// Base Case: If head is null then set head equal to e
-	if (head == nullptr) {
-		head = e;
-		mSize++; 
-		return;
-	}
-
-	Vertex *tmp = head;
-	Vertex *tmpPrev = head;
-	while (tmp != nullptr) {
-		if (tmp->point == e->point) {
-			return;
-		}
-		else {
-			tmpPrev = tmp;
-			tmp = tmp->setNext;
-		}
-	}
-	tmpPrev->setNext = tmp;
-	mSize++;						// Increment mSize
-	return;
-}
-
-VoronoiDiagram::Vertex* VoronoiDiagram::VertexUnorderedSet::pop() {
-	Vertex* tmp = head;				// Get head
-	if (tmp == nullptr) return nullptr;
-	head = head->setNext;			// Set head to 2nd in list
-	tmp->setNext = nullptr;			// Set next to null
-	mSize--;						// Decrement mSize
-	return tmp;						// Return
-}
-
-// HalfEdgeUnorderedSet
-
-VoronoiDiagram::HalfEdgeUnorderedSet::HalfEdgeUnorderedSet() {
-	head = nullptr;
-}
-
-void VoronoiDiagram::HalfEdgeUnorderedSet::emplace(HalfEdge* e) {
-	// Base Case: If head is null then set head equal to e
-	if (head == nullptr) {
-		head = e;
-		mSize++;
-		return;
-	}
-
-	HalfEdge *tmp = head;
-	HalfEdge *tmpPrev = head;
-	while (tmp != nullptr) {
-		if (tmp->origin != e->origin) {
-			return;
-		}
-		else {
-			tmpPrev = tmp;
-			tmp = tmp->setNext;
-		}
-	}
-	tmpPrev->setNext = tmp;
-	mSize++;						// Increment mSize
-	return;
-}
-
-bool VoronoiDiagram::HalfEdgeUnorderedSet::find(HalfEdge* e) {
-	HalfEdge* tmp = head;  // Initialize current 
-	while (tmp != nullptr)
-	{
-		if (tmp->origin == e->origin)
-			return true;
-		tmp = tmp->setNext;
-	}
-	return false;
+    return halfEdge < mHalfEdgeEpochs.size() && mHalfEdgeEpochs[halfEdge] == mEpoch;
 }
 
-// FaceVector
-
-VoronoiDiagram::FaceVector::FaceVector() {
-	head = nullptr;
-	tail = nullptr;
-}
-
-void VoronoiDiagram::FaceVector::push_back(Face* e) {
-	Face *tmp = head;
-	e->next = nullptr;
-	e->index = size();
-
-	if (head == nullptr)			// If list is empty make Face e the head
-	{
-		head = e;
-		tail = e;
-		mSize++;
-		return;
-	}
-
-	while (tmp->next != nullptr)		// Else traverse list until the last node
-		tmp = tmp->next;
-
-	tmp->next = e;					// Set tail's next as e
-	tail = e;						// Set e as new tail
-	mSize++;
-	return;
-}
-
-VoronoiDiagram::Face* VoronoiDiagram::FaceVector::back() {
-	return tail;
-}
-
-unsigned int VoronoiDiagram::FaceVector::size() {
-	return mSize;
-}
-
-VoronoiDiagram::Face* VoronoiDiagram::FaceVector::operator[](unsigned int index) {
-	if (index > mSize) {
-		return nullptr;					// If index is out of bounds return null
-	}
-	Face* tmp = head;
-	while (tmp->index != index) {
-		tmp = tmp->next;
-	}
-	return tmp;
-}
-
-
-VoronoiDiagram::Face* VoronoiDiagram::FaceVector::pop_front() {
-
-	Face* prevHead = head;
-	head = head->next;				// Set new head
-
-	Face* tmp = head;						// Set tmp to new head
-	while (tmp != nullptr) {	// Decrement all indexes
-		tmp->index--;
-		tmp = tmp->next;
-	}
-
-	mSize--;							// Decrement size
-	prevHead->next = nullptr;			// Remove previous head's next link
-	return prevHead;
+void VoronoiDiagram::setProcessed(unsigned int halfEdge)
+{
+    if (halfEdge >= mHalfEdgeEpochs.size())
+        mHalfEdgeEpochs.resize(mHalfEdges.size());
+    mHalfEdgeEpochs[halfEdge] = mEpoch;
 }
 
-// HalfEdgeList
-
-VoronoiDiagram::HalfEdgeList::HalfEdgeList() {
-	head = nullptr;
-	tail = nullptr;
-	mSize = 0;
+void VoronoiDiagram::markForRemoval(unsigned int vertex)
+{
+    mVerticesToRemove[vertex / 32] |= 1u << (vertex % 32);
 }
 
-void VoronoiDiagram::HalfEdgeList::emplace_back(HalfEdge* e) {
-	HalfEdge *tmp = head;
-	e->listNext = nullptr;
-
-	if (head == nullptr)			// If list is empty make HalfEdge e the head
-	{
-		head = e;
-		tail = e;
-		mSize++;
-		return;
-	}
-
-	while (tmp->listNext != nullptr)		// Else traverse list until the last node
-		tmp = tmp->listNext;
-
-	tmp->listNext = e;					// Set tail's next as e
-	tail = e;						// Set e as new tail
-	mSize++;
-	return;
+void VoronoiDiagram::removeVertices()
+{
+    // Compact the pool in one pass, the vertices created while clipping are after the bitmap
+    IndexPool<unsigned int>& newIndices = mNewVertexIndices;
+    newIndices.resize(mVertices.size());
+    unsigned int nbMarked = 32 * mVerticesToRemove.size();
+    unsigned int size = 0;
+    for (unsigned int i = 0; i < mVertices.size(); ++i)
+    {
+        if (i < nbMarked && (mVerticesToRemove[i / 32] >> (i % 32)) & 1)
+        {
+            newIndices[i] = NONE;
+            continue;
+        }
+        mVertices[size] = mVertices[i];
+        newIndices[i] = size++;
+    }
+    if (size == mVertices.size())
+        return;
+    mVertices.resize(size);
+    // Remap the half edges
+    for (unsigned int i = 0; i < mHalfEdges.size(); ++i)
+    {
+        HalfEdge& halfEdge = mHalfEdges[i];
+        if (halfEdge.origin != NONE)
+            halfEdge.origin = newIndices[halfEdge.origin];
+        if (halfEdge.destination != NONE)
+            halfEdge.destination = newIndices[halfEdge.destination];
+    }
 }
 
-VoronoiDiagram::HalfEdge* VoronoiDiagram::HalfEdgeList::back() {
-	return tail;
+void VoronoiDiagram::removeHalfEdge(unsigned int halfEdge)
+{
+    // The slot stays in the pool to keep the twins paired
+    mHalfEdges[halfEdge] = HalfEdge();
 }
 
 
-void VoronoiDiagram::HalfEdgeList::erase(HalfEdge* e) {
-	// Store head node 
-	HalfEdge *tmp = head;
-	HalfEdge* tmpPrev = head;
-
-	// If head node itself holds the key to be deleted 
-	if (tmp == e)
-	{
-		head = head->listNext;   // Changed head 
-		mSize--;
-		return;
-	}
-
-	// Search for the key to be deleted, keep track of the 
-	// previous node as we need to change 'tmpPrev->listNext' 
-	while (tmp != nullptr && tmp != e)
-	{
-		tmpPrev = tmp;
-		tmp = tmp->listNext;
-	}
-
-	// If halfedge was not present in linked list 
-	if (tmp == nullptr) return;
-
-	// Unlink the halfedge from linked list 
-	tmpPrev->listNext = tmp->listNext;
-	mSize--;
+// Algorithms for finding centroids
 
+VoronoiDiagram::FaceRange VoronoiDiagram::getFaceVertices(unsigned int face) const
+{
+    return FaceRange{FaceIterator(this, mFaces[face].outerComponent), FaceIterator(this, NONE)};
 }
 
-// VertexList
-
-VoronoiDiagram::VertexList::VertexList() {
-	head = nullptr;
-	tail = nullptr;
-	mSize = 0;
+unsigned int VoronoiDiagram::copyFaceVertices(unsigned int face, double* x, double* y, unsigned int capacity) const
+{
+    unsigned int size = 0;
+    FaceRange vertices = getFaceVertices(face);
+    for (FaceIterator it = vertices.begin(); it != vertices.end(); ++it)
+    {
+        if (size < capacity)
+        {
+            x[size] = (*it).x;
+            y[size] = (*it).y;
+        }
+        ++size;
+    }
+    return size;
 }
 
-void VoronoiDiagram::VertexList::emplace_back(Vertex* e) {
-	Vertex* tmp = head;
-	e->listNext = nullptr;
-
-	if (head == nullptr)			// If list is empty make HalfEdge e the head
-	{
-		head = e;
-		tail = e;
-		mSize++;
-		return;
-	}
-
-	while (tmp->listNext != nullptr)		// Else traverse list until the last node
-		tmp = tmp->listNext;
-
-	tmp->listNext = e;					// Set tail's next as e
-	tail = e;						// Set e as new tail
-	mSize++;
-	return;
+double VoronoiDiagram::getArea(unsigned int face) const
+{
+    // Shoelace formula on the edges of the face
+    double signedArea = 0.0;
+    FaceRange vertices = getFaceVertices(face);
+    for (FaceIterator it = vertices.begin(); it != vertices.end(); ++it)
+        signedArea += (*it).getDet(mVertices[mHalfEdges[it.getHalfEdge()].destination].point);
+    return 0.5 * signedArea;
 }
 
-VoronoiDiagram::Vertex* VoronoiDiagram::VertexList::back() {
-	return tail;
+Vector2 VoronoiDiagram::getCentroid(unsigned int face) const
+{
+    Vector2 centroid;
+    double signedArea = 0.0;
+    FaceRange vertices = getFaceVertices(face);
+    for (FaceIterator it = vertices.begin(); it != vertices.end(); ++it)
+    {
+        const Vector2& origin = *it;
+        const Vector2& destination = mVertices[mHalfEdges[it.getHalfEdge()].destination].point;
+        double a = origin.getDet(destination);
+        signedArea += a;
+        centroid += a * (origin + destination);
+    }
+    centroid *= 1.0 / (3.0 * signedArea);
+    return centroid;
 }
 
-void VoronoiDiagram::VertexList::erase(Vertex *e) {
-	// Store head node 
-	Vertex* tmp = head;
-	Vertex* tmpPrev = head;
-
-	// If head node itself holds the key to be deleted 
-	if (tmp == e)
-	{
-		head = head->listNext;   // Changed head 
-		mSize--;
-		return;
-	}
-
-	// Search for the key to be deleted, keep track of the 
-	// previous node as we need to change 'tmpPrev->listNext' 
-	while (tmp != nullptr && tmp != e)
-	{
-		tmpPrev = tmp;
-		tmp = tmp->listNext;
-	}
-
-	// If halfedge was not present in linked list 
-	if (tmp == nullptr) return;
-
-	// Unlink the halfedge from linked list 
-	tmpPrev->listNext = tmp->listNext;
-	mSize--;
+ Vector2Vector VoronoiDiagram::getCentroids(ThreadPool* threadPool) const {
+	 Vector2Vector centroids(mFaces.getMemoryResource());
+	 centroids.resize(mFaces.size());
+	 parallelFor(threadPool, mFaces.size(), [this, &centroids](unsigned int begin, unsigned int end) {
+		 for (unsigned int i = begin; i < end; ++i)
+			 centroids[i] = getCentroid(i);
+	 });
+	 return centroids;
+ }
 
+void VoronoiDiagram::computeCellMeasures(CellMeasures measures, ThreadPool* threadPool) const
+{
+    parallelFor(threadPool, mFaces.size(), [this, measures](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            // Same sums as getArea and getCentroid plus the length of the edges and the second
+            // moment, the vertices are taken relative to the site to limit the cancellations
+            const Vector2& site = mSites[mFaces[i].site].point;
+            Vector2 centroid;
+            double signedArea = 0.0;
+            double perimeter = 0.0;
+            double energy = 0.0;
+            FaceRange vertices = getFaceVertices(i);
+            for (FaceIterator it = vertices.begin(); it != vertices.end(); ++it)
+            {
+                Vector2 origin = *it - site;
+                Vector2 destination = mVertices[mHalfEdges[it.getHalfEdge()].destination].point - site;
+                double a = origin.getDet(destination);
+                signedArea += a;
+                centroid += a * (origin + destination);
+                perimeter += origin.getDistance(destination);
+                energy += a * (origin.getSquaredNorm() + origin.dot(destination) + destination.getSquaredNorm());
+            }
+            centroid *= 1.0 / (3.0 * signedArea);
+            centroid += site;
+            if (measures.centroidX != nullptr)
+                measures.centroidX[i] = centroid.x;
+            if (measures.centroidY != nullptr)
+                measures.centroidY[i] = centroid.y;
+            if (measures.area != nullptr)
+                measures.area[i] = 0.5 * signedArea;
+            if (measures.perimeter != nullptr)
+                measures.perimeter[i] = perimeter;
+            if (measures.energy != nullptr)
+                measures.energy[i] = energy / 12.0;
+        }
+    });
 }
-
-VoronoiDiagram::Vertex* VoronoiDiagram::VertexList::get(unsigned int index) {
-	// Base Case: if index is greater than node in list, return nullptr
-	if (index > mSize) {
-		return nullptr;
-	}
-
-	// Else traverse list until tmp is at position of index
-	Vertex* tmp = head;
-	int counter = 0;
-
-	while (counter != index) {
-		tmp = tmp->listNext;
-		counter++;
-	}
-	return tmp;
-}
\ No newline at end of file
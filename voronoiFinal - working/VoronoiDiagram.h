@@ -2,195 +2,227 @@
 
 // My includes
 #include "Box.h"
+#include "IndexPool.h"
+#include "PointSpan.h"
 #include "Vector2Vector.h"
 
 
-class FortuneAlgorithm;
+template<typename BeachlineType> class BasicFortuneAlgorithm;
+template<typename BeachlineType> class BasicParallelFortuneAlgorithm;
+class ThreadPool;
 
+// Bounding helpers
+struct LinkedVertex
+{
+    unsigned int prevHalfEdge;
+    unsigned int vertex;
+    unsigned int nextHalfEdge;
+};
+
+// Vertices of a cell on the box, slot 2 * side is the first one on that side and
+// 2 * side + 1 the last one counterclockwise, a corner is shared by two consecutive slots
+struct LinkedVertexArray
+{
+    unsigned int site;
+    unsigned int slots[8]; // Indices of linked vertices, NONE if the slot is empty
+};
+
+// Doubly connected edge list, every entity lives in its own pool and is referenced by its index
 class VoronoiDiagram
 {
 public:
-    struct HalfEdge;
-    struct Face;
+    // Index of a link that is not set
+    static constexpr unsigned int NONE = 0xFFFFFFFF;
 
     struct Site
     {
         unsigned int index;
         Vector2 point;
-        Face* face;
-
-		// Used in SiteVector
-		Site* next;
+        unsigned int face;
     };
 
-	struct SiteVector {
-		Site* head;
-		Site* tail;
-		unsigned int mSize;
-
-		// Constructor
-		SiteVector();
-
-		// Operations
-		void push_back(Site* e);
-		Site* back();
-		const unsigned int size() const;
-
-		// Operators
-		Site* operator[](unsigned int index);
-
-	};
-
     struct Vertex
     {
         Vector2 point;
-
-		//Used in VertexList
-		Vertex* listNext;
-
-		//Used in VertexUnorderedSet
-		Vertex* setNext;
-
-    private:
-        friend VoronoiDiagram;
     };
 
-	struct VertexUnorderedSet {
-		Vertex *head;
-		int mSize;
-
-		// Constructor
-		VertexUnorderedSet();
-
-		// Operations
-		void emplace(Vertex* e);
-		Vertex* pop();
-	};
-
-	struct VertexList {
-		Vertex* head;
-		Vertex* tail;
-		int mSize;
-
-		// Constructor
-		VertexList();
-
-		// Operations
-		void emplace_back(Vertex* v);
-		Vertex* back();
-		void erase(Vertex* e);
-		Vertex* get(unsigned int i);
-
-	};
-
+    // Half edges are allocated by pairs so that the twin of i is i ^ 1
     struct HalfEdge
     {
-        Vertex* origin = nullptr;
-        Vertex* destination = nullptr;
-        HalfEdge* twin = nullptr;
-        Face* incidentFace;
-        HalfEdge* prev = nullptr;
-        HalfEdge* next = nullptr;
+        unsigned int origin = NONE;
+        unsigned int destination = NONE;
+        unsigned int incidentFace = NONE;
+        unsigned int prev = NONE;
+        unsigned int next = NONE;
+    };
 
-		// Used in HalfEdgeUnorderedSet
-		HalfEdge* setNext;
+    struct Face
+    {
+        unsigned int site;
+        unsigned int outerComponent;
+    };
 
-		// Used in HalfEdgeList
-		HalfEdge* listNext;
+    // Walks the boundary of a face from its outer component and yields the origin of
+    // each half edge in place, the walk stops when it comes back or reaches an open end
+    class FaceIterator
+    {
+    public:
+        FaceIterator(const VoronoiDiagram* diagram, unsigned int halfEdge) :
+            mDiagram(diagram), mStart(halfEdge), mHalfEdge(halfEdge)
+        {
+
+        }
+
+        const Vector2& operator*() const
+        {
+            return mDiagram->mVertices[mDiagram->mHalfEdges[mHalfEdge].origin].point;
+        }
+
+        FaceIterator& operator++()
+        {
+            mHalfEdge = mDiagram->mHalfEdges[mHalfEdge].next;
+            if (mHalfEdge == mStart)
+                mHalfEdge = NONE;
+            return *this;
+        }
+
+        bool operator!=(const FaceIterator& other) const
+        {
+            return mHalfEdge != other.mHalfEdge;
+        }
+
+        unsigned int getHalfEdge() const
+        {
+            return mHalfEdge;
+        }
 
     private:
-        friend VoronoiDiagram;
+        const VoronoiDiagram* mDiagram;
+        unsigned int mStart;
+        unsigned int mHalfEdge;
     };
 
-	struct HalfEdgeUnorderedSet {
-		HalfEdge* head;
-		int mSize;
-
-		// Constructor
-		HalfEdgeUnorderedSet();
-
-		// Operations
-		void emplace(HalfEdge* e);
-		bool find(HalfEdge* e);
-
-	};
-
-	struct HalfEdgeList {
-		HalfEdge* head;
-		HalfEdge* tail;
-		int mSize;
-
-		// Constructor
-		HalfEdgeList();
-
-		// Operations
-		void emplace_back(HalfEdge* e);
-		HalfEdge* back();
-		void erase(HalfEdge *e);
-
-	};
-
-    struct Face
+    // Per face outputs of computeCellMeasures, allocated by the caller with one entry per face,
+    // the arrays that are null are not written
+    struct CellMeasures
     {
-        Site* site;
-        HalfEdge* outerComponent;
-
-		// Used in FaceVertex
-		Face* next;
-		int index;
+        double* centroidX;
+        double* centroidY;
+        double* area;
+        double* perimeter;
+        double* energy; // Integral of the squared distance to the site over the face
     };
 
-	struct FaceVector {
-		Face* head;
-		Face* tail;
-		unsigned int mSize;
-
-		// Constructor
-		FaceVector();
+    struct FaceRange
+    {
+        FaceIterator first;
+        FaceIterator last;
+
+        FaceIterator begin() const
+        {
+            return first;
+        }
+
+        FaceIterator end() const
+        {
+            return last;
+        }
+    };
 
-		// Operations
-		void push_back(Face* e);
-		Face* back();
-		Face* pop_front();
-		unsigned int size();
+    // All the pools of the diagram take their memory from the resource, nullptr for the default one
+    explicit VoronoiDiagram(MemoryResource* resource = nullptr);
+    VoronoiDiagram(const Vector2Vector& points, MemoryResource* resource = nullptr);
+    VoronoiDiagram(PointSpan points, MemoryResource* resource = nullptr);
 
-		// Operators
-		Face* operator[](unsigned int index);
-	};
+    // The diagram owns its pools, it can be moved but not copied. A moved diagram keeps its resource
+    VoronoiDiagram(const VoronoiDiagram&) = delete;
+    VoronoiDiagram(VoronoiDiagram&&) = default;
+    VoronoiDiagram& operator=(const VoronoiDiagram&) = delete;
+    VoronoiDiagram& operator=(VoronoiDiagram&&) = default;
 
-    VoronoiDiagram(Vector2Vector points);
+    // Replace the sites and remove everything else, the pools keep their capacity
+    void reset(const Vector2Vector& points);
+    // Same but the sites are read straight from the caller's coordinates
+    void reset(PointSpan points);
 
 
 
     // Accessors
     Site* getSite(unsigned int i);
+    const Site* getSite(unsigned int i) const;
     unsigned int getNbSites() const;
     Face* getFace(unsigned int i);
-    const VertexList getVertices() const;
+    const Face* getFace(unsigned int i) const;
+    Vertex* getVertex(unsigned int i);
+    const Vertex* getVertex(unsigned int i) const;
+    HalfEdge* getHalfEdge(unsigned int i);
+    const HalfEdge* getHalfEdge(unsigned int i) const;
+    // Views on the pools, nothing is copied
+    const IndexPool<Vertex>& getVertices() const;
+    const IndexPool<HalfEdge>& getHalfEdges() const;
+    MemoryResource* getMemoryResource() const;
+
+    static unsigned int getTwin(unsigned int halfEdge)
+    {
+        return halfEdge ^ 1;
+    }
 
+    // Close the infinite edges and the unbounded cells on a box, it is enlarged to contain all the vertices.
+    // The infinite edges are the half edges without origin so any diagram built by sweeps can be bounded.
+    bool bound(Box box);
     // Intersection with a box
     bool intersect(Box box);
 
-	 Vector2Vector getFaceVertex(Face f);								// Gets all vertexes of a face
-	 Vector2* getCentroid(Vector2Vector myVertices);						// Gets the centroid of a face
-	 Vector2Vector getCentroids();										// Gets the centroids of all faces
+    // Cells, computed in one pass over the half edges without allocation
+    FaceRange getFaceVertices(unsigned int face) const;
+    // Writes at most capacity vertices of the face as packed coordinates and returns their total number
+    unsigned int copyFaceVertices(unsigned int face, double* x, double* y, unsigned int capacity) const;
+    double getArea(unsigned int face) const;
+    Vector2 getCentroid(unsigned int face) const;
+	 Vector2Vector getCentroids(ThreadPool* threadPool = nullptr) const;			// Gets the centroids of all faces, from the resource of the diagram
+    // Centroid, area and perimeter of every face split over the threads of the pool, nullptr for the
+    // calling thread alone, the results are the same whatever the number of threads
+    void computeCellMeasures(CellMeasures measures, ThreadPool* threadPool = nullptr) const;
 		
 private:
-    SiteVector mSites;
-    FaceVector mFaces;
-    VertexList mVertices;
-    HalfEdgeList mHalfEdges;
+    IndexPool<Site> mSites;
+    IndexPool<Face> mFaces;
+    IndexPool<Vertex> mVertices;
+    IndexPool<HalfEdge> mHalfEdges;
 	Box::intersectionArray intersections;
+    // Clipping state, a half edge is processed if it is stamped with the current epoch
+    // so that nothing has to be cleared between two intersections
+    IndexPool<unsigned int> mHalfEdgeEpochs;
+    unsigned int mEpoch = 0;
+    // One bit per vertex to remove
+    IndexPool<unsigned int> mVerticesToRemove;
+    IndexPool<unsigned int> mNewVertexIndices;
+    // Bounding, the cells are indexed by site and the vertices are shared between slots
+    IndexPool<LinkedVertex> mLinkedVertices;
+    IndexPool<LinkedVertexArray> mBoundaryCells;
+    IndexPool<unsigned int> mBoundaryCellOfSite;
 
     // Diagram construction
-    friend FortuneAlgorithm;
+    template<typename BeachlineType> friend class BasicFortuneAlgorithm;
+    friend class CellStitcher;
+
+    void clear(unsigned int nbSites);
+
+    unsigned int createVertex(Vector2 point);
+    unsigned int createCorner(Box box, Box::Side side);
+    unsigned int createEdge(unsigned int leftFace, unsigned int rightFace);
+    unsigned int createHalfEdge(unsigned int face);
 
-    Vertex* createVertex(Vector2 point);
-    Vertex* createCorner(Box box, Box::Side side);
-    HalfEdge* createHalfEdge(Face* face);
+    // Bounding
+    LinkedVertexArray& getBoundaryCell(unsigned int site);
+    unsigned int addLinkedVertex(unsigned int prevHalfEdge, unsigned int vertex, unsigned int nextHalfEdge);
 
     // Intersection with a box
-    void link(Box box, HalfEdge* start, Box::Side startSide, HalfEdge* end, Box::Side endSide);
-    void removeVertex(Vertex* vertex);
-    void removeHalfEdge(HalfEdge* halfEdge);
+    void link(Box box, unsigned int start, Box::Side startSide, unsigned int end, Box::Side endSide);
+    void startClipping();
+    bool isProcessed(unsigned int halfEdge) const;
+    void setProcessed(unsigned int halfEdge);
+    void markForRemoval(unsigned int vertex);
+    void removeVertices();
+    void removeHalfEdge(unsigned int halfEdge);
 };
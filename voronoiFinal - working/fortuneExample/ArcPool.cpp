@@ -0,0 +1,11 @@
+#include "ArcPool.h"
+
+ArcPool::ArcPool(MemoryResource* resource) : SlabPool(resource) {
+
+}
+
+Arc* ArcPool::create(VoronoiDiagram::Site* site, Arc* nil) {
+	Arc* arc = allocate();
+	*arc = Arc{nil, nil, nil, site, site->point.x, site->point.y, VoronoiDiagram::NONE, VoronoiDiagram::NONE, nullptr, nil, nil, Arc::Color::RED, 0};
+	return arc;
+}
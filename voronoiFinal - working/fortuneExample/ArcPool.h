@@ -0,0 +1,14 @@
+#pragma once
+
+#include "Arc.h"
+#include "SlabPool.h"
+
+// Owns the arcs of a beachline, the next pointer of a released arc chains the free arcs
+class ArcPool : public SlabPool<Arc, &Arc::next>
+{
+public:
+	// nullptr takes the slabs from the default resource
+	explicit ArcPool(MemoryResource* resource = nullptr);
+
+	Arc* create(VoronoiDiagram::Site* site, Arc* nil);
+};
@@ -0,0 +1,11 @@
+#include "EventPool.h"
+
+EventPool::EventPool(MemoryResource* resource) : SlabPool(resource) {
+
+}
+
+Event* EventPool::create(double y, Vector2 point, Arc* arc) {
+	Event* event = allocate();
+	*event = Event(y, point, arc);
+	return event;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "Event.h"
+#include "SlabPool.h"
+
+// Owns the events of a FortuneAlgorithm, a released event is chained through nextFree
+class EventPool : public SlabPool<Event, &Event::nextFree>
+{
+public:
+	// nullptr takes the slabs from the default resource
+	explicit EventPool(MemoryResource* resource = nullptr);
+
+	Event* create(double y, Vector2 point, Arc* arc);
+};
@@ -1,47 +1,46 @@
 #include "EventVector.h"
 
 // Constructor
-eventVector::eventVector() {
-	head = nullptr;
+eventVector::eventVector(MemoryResource* resource) {
+	mData = nullptr;
+	mSize = 0;
+	mCapacity = 0;
+	mResource = resource != nullptr ? resource : getDefaultMemoryResource();
 }
 
 //Destructor
 eventVector::~eventVector() {
-	delete head;
+	destroyArray(mResource, mData, mCapacity);
 }
 
 bool eventVector::empty() const {
-	if (mSize == 0) {
-		return true;
-	}
-	else {
-		return false;
-	}
+	return mSize == 0;
 }
 
-unsigned int eventVector::size() {
+unsigned int eventVector::size() const {
 	return mSize;
 }
 
-void eventVector::push_back(Event *e) {
-
-	Event *tmp = head;  
-	e->next = nullptr;
+void eventVector::reserve(unsigned int capacity) {
+	if (capacity <= mCapacity) return;		// Never shrink
 
-	if (head == nullptr)			// If list is empty make Event e the head
-	{
-		head = e;
-		mSize++;
-		return;
-	}
+	Event **data = createArray<Event*>(mResource, capacity);
+	for (unsigned int i = 0; i < mSize; ++i)
+		data[i] = mData[i];
+	destroyArray(mResource, mData, mCapacity);
+	mData = data;
+	mCapacity = capacity;
+}
 
-	while (tmp->next != nullptr)		// Else traverse list until the last node
-		tmp = tmp->next;
+// Keeps the capacity
+void eventVector::clear() {
+	mSize = 0;
+}
 
-	tmp->next = e;					// Set tail's next as e
-	tail = e;						// Set e as new tail
-	mSize++;
-	return;
+void eventVector::push_back(Event *e) {
+	if (mSize == mCapacity)				// Grow geometrically so push_back is amortized O(1)
+		reserve(mCapacity == 0 ? 16 : 2 * mCapacity);
+	mData[mSize++] = e;
 }
 
 void eventVector::emplace_back(Event *e) {
@@ -52,83 +51,26 @@ Event* eventVector::pop_back() {
 	if (mSize == 0) {
 		return nullptr;			// If vector is empty return null
 	}
-	Event *tmp;
-	if (mSize == 1) {						// If head is the only member of vector, return head
-		tmp = head;
-		head = nullptr;
-		mSize = 0;
-		tmp->next = nullptr;
-		return tmp;
-	}
-		
-	Event *i = head;
-	while(i->next->next != nullptr){
-		i = i->next;
-	}
-	tail = i;
-	tmp = tail->next;
-	tail->next = nullptr;
-	mSize--;
-	return tmp;
+	return mData[--mSize];
 }
 
 
 void eventVector::swap(unsigned int i, unsigned int j) {
 	if (i == j) return;							// If i == j, do nothing
 
-	
-	Event *prevI = nullptr, *currI = head;			// Search for Event I and its preceeding event
-	while (currI && currI->index != i)
-	{
-		prevI = currI;
-		currI = currI->next;
-	}
-
-	
-	Event *prevJ = nullptr, *currJ = head;			// Search for Event J and its preceeding Event
-	while (currJ && currJ->index != j)
-	{
-		prevJ = currJ;
-		currJ = currJ->next;
-	}
-
-	
-	if (currI == nullptr || currJ == nullptr)			// If either x or y is not present, nothing to do
-		return;
-
-	
-	if (prevI != nullptr)							// If i is not head of linked list 
-		prevI->next = currJ;
-	else										// Else make j as new head 
-		head = currJ;
-
-	// If j is not head of linked list 
-	if (prevJ != nullptr)
-		prevJ->next = currI;
-	else  // Else make i as new head 
-		head = currI;
-
-	// Swap next pointers 
-	Event *tmp = currJ->next;
-	currJ->next = currI->next;
-	currI->next = tmp;
+	Event *tmp = mData[i];
+	mData[i] = mData[j];
+	mData[j] = tmp;
 
 	// Set new indices
-	currI->index = j;
-	currJ->index = i;
+	mData[i]->index = i;
+	mData[j]->index = j;
 }
 
 
-
-
-
-Event* eventVector::operator[](unsigned int index) {
-	if (index > mSize) {
+Event* eventVector::operator[](unsigned int index) const {
+	if (index >= mSize) {
 		return nullptr;					// If index is out of bounds return null
 	}
-	Event *tmp = head;
-	while(tmp->index != index) {
-		tmp = tmp->next;
-	}
-	return tmp;
-}
\ No newline at end of file
+	return mData[index];
+}
@@ -1,20 +1,29 @@
 #pragma once
 
 #include "Event.h"
+#include "MemoryResource.h"
 
+// Contiguous array of Event* used as the storage of the PriorityQueue heap
 struct eventVector
 {
-	Event *head;
-	Event *tail;
-	unsigned int mSize = 0;
+	Event **mData;
+	unsigned int mSize;
+	unsigned int mCapacity;
+	MemoryResource* mResource;
 
-	// Default constructor
-	eventVector();
+	// nullptr takes the buffer from the default resource
+	explicit eventVector(MemoryResource* resource = nullptr);
 	~eventVector();
 
+	// Remove copy operations, the vector owns its buffer
+	eventVector(const eventVector&) = delete;
+	eventVector& operator=(const eventVector&) = delete;
+
 	// Necessary vector functions
 	bool empty() const;
-	unsigned int size();
+	unsigned int size() const;
+	void reserve(unsigned int capacity);
+	void clear();
 	void push_back(Event *e);
 	void emplace_back(Event *e);
 	Event* pop_back();
@@ -22,6 +31,5 @@ struct eventVector
 	void swap(unsigned int i, unsigned int j);
 	
 	// [] Operator
-	Event* operator[](unsigned int index);
+	Event* operator[](unsigned int index) const;
 };
-
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "MemoryResource.h"
+
+// Contiguous storage whose elements are addressed by 32-bit indices.
+// Indices stay valid when the pool grows, pointers and references do not.
+template<typename T>
+struct IndexPool {
+	T* mData;
+	unsigned int mSize;
+	unsigned int mCapacity;
+	MemoryResource* mResource;
+
+	// Constructors and Destructor
+	IndexPool() : mData(nullptr), mSize(0), mCapacity(0), mResource(getDefaultMemoryResource()) {
+
+	}
+
+	// nullptr takes the memory from the default resource
+	explicit IndexPool(MemoryResource* resource) : mData(nullptr), mSize(0), mCapacity(0),
+		mResource(resource != nullptr ? resource : getDefaultMemoryResource()) {
+
+	}
+
+	// The copy uses the default resource
+	IndexPool(const IndexPool& other) : mData(nullptr), mSize(0), mCapacity(0), mResource(getDefaultMemoryResource()) {
+		*this = other;
+	}
+
+	// Takes the storage and its resource, other is left empty with the same resource
+	IndexPool(IndexPool&& other) : mData(other.mData), mSize(other.mSize), mCapacity(other.mCapacity), mResource(other.mResource) {
+		other.mData = nullptr;
+		other.mSize = 0;
+		other.mCapacity = 0;
+	}
+
+	~IndexPool() {
+		destroyArray(mResource, mData, mCapacity);
+	}
+
+	// Operators
+	IndexPool& operator=(const IndexPool& other) {
+		if (this == &other) return *this;
+		mSize = 0;
+		reserve(other.mSize);
+		for (unsigned int i = 0; i < other.mSize; ++i)
+			mData[i] = other.mData[i];
+		mSize = other.mSize;
+		return *this;
+	}
+
+	IndexPool& operator=(IndexPool&& other) {
+		if (this == &other) return *this;
+		destroyArray(mResource, mData, mCapacity);
+		mData = other.mData;
+		mSize = other.mSize;
+		mCapacity = other.mCapacity;
+		mResource = other.mResource;
+		other.mData = nullptr;
+		other.mSize = 0;
+		other.mCapacity = 0;
+		return *this;
+	}
+
+	T& operator[](unsigned int i) {
+		return mData[i];
+	}
+
+	const T& operator[](unsigned int i) const {
+		return mData[i];
+	}
+
+	// Operations
+	bool empty() const {
+		return mSize == 0;
+	}
+
+	unsigned int size() const {
+		return mSize;
+	}
+
+	MemoryResource* getMemoryResource() const {
+		return mResource;
+	}
+
+	void reserve(unsigned int capacity) {
+		if (capacity <= mCapacity) return;		// Never shrink
+
+		T* data = createArray<T>(mResource, capacity);
+		for (unsigned int i = 0; i < mSize; ++i)
+			data[i] = mData[i];
+		destroyArray(mResource, mData, mCapacity);
+		mData = data;
+		mCapacity = capacity;
+	}
+
+	// Appends n default elements and returns the index of the first one
+	unsigned int allocate(unsigned int n) {
+		if (mSize + n > mCapacity) {			// Grow geometrically so allocation is amortized O(1)
+			unsigned int capacity = mCapacity == 0 ? 16 : 2 * mCapacity;
+			reserve(capacity < mSize + n ? mSize + n : capacity);
+		}
+		unsigned int first = mSize;
+		for (unsigned int i = 0; i < n; ++i)
+			mData[mSize++] = T();
+		return first;
+	}
+
+	unsigned int push_back(const T& e) {
+		unsigned int i = allocate(1);
+		mData[i] = e;
+		return i;
+	}
+
+	T& back() {
+		return mData[mSize - 1];
+	}
+
+	// Keeps the capacity
+	void clear() {
+		mSize = 0;
+	}
+
+	// Keeps the first n elements
+	void resize(unsigned int n) {
+		if (n < mSize)
+			mSize = n;
+		else
+			allocate(n - mSize);
+	}
+};
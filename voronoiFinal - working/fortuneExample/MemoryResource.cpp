@@ -0,0 +1,51 @@
+#include "MemoryResource.h"
+
+namespace {
+
+// No structure of the library needs more than the alignment of std::max_align_t, that operator new gives
+class NewDeleteResource : public MemoryResource {
+protected:
+	void* doAllocate(std::size_t bytes, std::size_t) override {
+		return ::operator new(bytes);
+	}
+
+	void doDeallocate(void* p, std::size_t, std::size_t) override {
+		::operator delete(p);
+	}
+};
+
+}
+
+MemoryResource* getDefaultMemoryResource() {
+	static NewDeleteResource resource;
+	return &resource;
+}
+
+MonotonicBufferResource::MonotonicBufferResource(void* buffer, std::size_t size) :
+	mBuffer(static_cast<unsigned char*>(buffer)), mSize(size), mUsedSize(0) {
+
+}
+
+std::size_t MonotonicBufferResource::getUsedSize() const {
+	return mUsedSize;
+}
+
+void MonotonicBufferResource::release() {
+	mUsedSize = 0;
+}
+
+void* MonotonicBufferResource::doAllocate(std::size_t bytes, std::size_t alignment) {
+	// The alignment is a power of two, round the address of the first free byte up to it
+	std::size_t address = reinterpret_cast<std::size_t>(mBuffer + mUsedSize);
+	std::size_t padding = (alignment - address % alignment) % alignment;
+	if (padding > mSize - mUsedSize || bytes > mSize - mUsedSize - padding)
+		throw std::bad_alloc();
+	void* p = mBuffer + mUsedSize + padding;
+	mUsedSize += padding + bytes;
+	return p;
+}
+
+// The memory is only given back by release()
+void MonotonicBufferResource::doDeallocate(void*, std::size_t, std::size_t) {
+
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+// STL
+#include <cstddef>
+#include <new>
+
+// Source of the memory of the pools, in the manner of std::pmr::memory_resource. A resource given
+// to a diagram or a builder is used by every structure they own, always from the thread that calls
+// them, so it does not have to be thread safe. The storage and its resource move together.
+class MemoryResource {
+public:
+	virtual ~MemoryResource() = default;
+
+	void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) {
+		return doAllocate(bytes, alignment);
+	}
+
+	void deallocate(void* p, std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) {
+		doDeallocate(p, bytes, alignment);
+	}
+
+protected:
+	virtual void* doAllocate(std::size_t bytes, std::size_t alignment) = 0;
+	virtual void doDeallocate(void* p, std::size_t bytes, std::size_t alignment) = 0;
+};
+
+// Global operator new and delete, used wherever no resource is given
+MemoryResource* getDefaultMemoryResource();
+
+// Hands out a buffer of the caller in order and never reuses what is deallocated until release(),
+// e.g. one arena per request or a static buffer reserved at startup. Throws std::bad_alloc like
+// operator new when the buffer is full.
+class MonotonicBufferResource : public MemoryResource {
+public:
+	MonotonicBufferResource(void* buffer, std::size_t size);
+
+	// Remove copy operations, the pools keep pointers to their resource
+	MonotonicBufferResource(const MonotonicBufferResource&) = delete;
+	MonotonicBufferResource& operator=(const MonotonicBufferResource&) = delete;
+
+	// Bytes handed out so far, padding included
+	std::size_t getUsedSize() const;
+	// Start over from the beginning of the buffer, nothing allocated before may be used anymore
+	void release();
+
+protected:
+	void* doAllocate(std::size_t bytes, std::size_t alignment) override;
+	void doDeallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+
+private:
+	unsigned char* mBuffer;
+	std::size_t mSize;
+	std::size_t mUsedSize;
+};
+
+// Arrays of n default-initialized elements taken from a resource, as new T[n] and delete[] do
+
+template<typename T>
+T* createArray(MemoryResource* resource, unsigned int n) {
+	T* data = static_cast<T*>(resource->allocate(n * sizeof(T), alignof(T)));
+	for (unsigned int i = 0; i < n; ++i)
+		new (data + i) T;
+	return data;
+}
+
+template<typename T>
+void destroyArray(MemoryResource* resource, T* data, unsigned int n) {
+	if (data == nullptr) return;
+	for (unsigned int i = 0; i < n; ++i)
+		data[i].~T();
+	resource->deallocate(data, n * sizeof(T), alignof(T));
+}
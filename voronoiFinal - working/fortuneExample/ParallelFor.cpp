@@ -0,0 +1,81 @@
+#include "ParallelFor.h"
+
+ThreadPool::ThreadPool(unsigned int nbThreads, MemoryResource* resource) :
+	mResource(resource != nullptr ? resource : getDefaultMemoryResource()), mNbThreads(::getNbThreads(nbThreads))
+#ifdef VORONOI_THREADS
+	, mThreads(nullptr), mGeneration(0), mIsStopping(false), mN(0), mNbBlocks(0), mNbPendingBlocks(0),
+	mBlockFunction(nullptr), mFunction(nullptr)
+#endif
+{
+#ifdef VORONOI_THREADS
+	if (mNbThreads > 1) {
+		mThreads = createArray<std::thread>(mResource, mNbThreads - 1);
+		for (unsigned int i = 0; i < mNbThreads - 1; ++i)
+			mThreads[i] = std::thread(&ThreadPool::work, this, i);
+	}
+#endif
+}
+
+ThreadPool::~ThreadPool() {
+#ifdef VORONOI_THREADS
+	if (mThreads == nullptr)
+		return;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mIsStopping = true;
+	}
+	mStartCondition.notify_all();
+	for (unsigned int i = 0; i < mNbThreads - 1; ++i)
+		mThreads[i].join();
+	destroyArray(mResource, mThreads, mNbThreads - 1);
+#endif
+}
+
+unsigned int ThreadPool::getNbThreads() const {
+	return mNbThreads;
+}
+
+#ifdef VORONOI_THREADS
+
+void ThreadPool::run(unsigned int n, unsigned int nbBlocks, BlockFunction blockFunction, void* function) {
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mN = n;
+		mNbBlocks = nbBlocks;
+		mNbPendingBlocks = nbBlocks - 1;
+		mBlockFunction = blockFunction;
+		mFunction = function;
+		++mGeneration;
+	}
+	mStartCondition.notify_all();
+	blockFunction(function, getChunkStart(n, nbBlocks, nbBlocks - 1), n);
+	// The call and the function stay alive until the other blocks are done
+	std::unique_lock<std::mutex> lock(mMutex);
+	mEndCondition.wait(lock, [this] { return mNbPendingBlocks == 0; });
+}
+
+// Thread i takes block i of the calls with more than i + 1 blocks, a call ends only when its blocks
+// are done so a thread that has a block never misses its generation
+void ThreadPool::work(unsigned int thread) {
+	unsigned long long generation = 0;
+	std::unique_lock<std::mutex> lock(mMutex);
+	while (true) {
+		mStartCondition.wait(lock, [this, generation] { return mIsStopping || mGeneration != generation; });
+		if (mIsStopping)
+			return;
+		generation = mGeneration;
+		if (thread + 1 >= mNbBlocks)
+			continue;
+		unsigned int begin = getChunkStart(mN, mNbBlocks, thread);
+		unsigned int end = getChunkStart(mN, mNbBlocks, thread + 1);
+		BlockFunction blockFunction = mBlockFunction;
+		void* function = mFunction;
+		lock.unlock();
+		blockFunction(function, begin, end);
+		lock.lock();
+		if (--mNbPendingBlocks == 0)
+			mEndCondition.notify_one();
+	}
+}
+
+#endif
@@ -0,0 +1,111 @@
+#pragma once
+
+// My includes
+#include "MemoryResource.h"
+
+// Threads are used unless VORONOI_NO_THREADS is defined, e.g. on targets without an OS
+#ifndef VORONOI_NO_THREADS
+#define VORONOI_THREADS
+// STL
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+// Fewest elements given to a thread, smaller ranges are not worth a thread
+constexpr unsigned int PARALLEL_MIN_BLOCK_SIZE = 256;
+
+// Number of threads actually used for nbThreads, 0 for all the hardware threads
+inline unsigned int getNbThreads(unsigned int nbThreads) {
+#ifdef VORONOI_THREADS
+	if (nbThreads == 0)
+		nbThreads = std::thread::hardware_concurrency();
+	return nbThreads > 0 ? nbThreads : 1;
+#else
+	(void)nbThreads;
+	return 1;
+#endif
+}
+
+// First element of a chunk when n elements are cut in nbChunks chunks of the same size
+inline unsigned int getChunkStart(unsigned int n, unsigned int nbChunks, unsigned int chunk) {
+	return static_cast<unsigned int>(static_cast<unsigned long long>(n) * chunk / nbChunks);
+}
+
+// Threads started once by a builder and woken for each parallelFor, so that a call costs a wake-up
+// instead of the creation of the threads. The calling thread is one of the getNbThreads() threads.
+// The array of the threads comes from the resource, only the start of the threads by the runtime
+// allocates outside of it, and a call allocates nothing. Only one thread may call parallelFor at a
+// time and the function must not call parallelFor on the same pool.
+class ThreadPool {
+public:
+	// nbThreads = 0 uses all the hardware threads. nullptr takes the memory from the default resource
+	explicit ThreadPool(unsigned int nbThreads = 0, MemoryResource* resource = nullptr);
+	~ThreadPool();
+
+	// Remove copy operations, the threads keep a pointer to the pool
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	unsigned int getNbThreads() const;
+
+	// Calls function(begin, end) on contiguous blocks covering [0, n), one block per thread.
+	// The calling thread takes the last block. Each element is processed by exactly one call,
+	// so results written per element do not depend on the number of threads. Coarse elements,
+	// e.g. whole sweeps, lower minBlockSize.
+	template<typename Function>
+	void parallelFor(unsigned int n, Function function, unsigned int minBlockSize = PARALLEL_MIN_BLOCK_SIZE);
+
+private:
+	// The function of a call is reached through a pointer, so that it is not copied
+	using BlockFunction = void (*)(void* function, unsigned int begin, unsigned int end);
+
+	MemoryResource* mResource;
+	unsigned int mNbThreads;
+#ifdef VORONOI_THREADS
+	// The getNbThreads() - 1 other threads
+	std::thread* mThreads;
+	std::mutex mMutex;
+	std::condition_variable mStartCondition;
+	std::condition_variable mEndCondition;
+	// Current call, a new generation wakes the threads
+	unsigned long long mGeneration;
+	bool mIsStopping;
+	unsigned int mN;
+	unsigned int mNbBlocks;
+	unsigned int mNbPendingBlocks;
+	BlockFunction mBlockFunction;
+	void* mFunction;
+
+	void run(unsigned int n, unsigned int nbBlocks, BlockFunction blockFunction, void* function);
+	void work(unsigned int thread);
+#endif
+};
+
+template<typename Function>
+void ThreadPool::parallelFor(unsigned int n, Function function, unsigned int minBlockSize) {
+#ifdef VORONOI_THREADS
+	unsigned int nbBlocks = mNbThreads;
+	unsigned int maxBlocks = n / minBlockSize;
+	if (nbBlocks > maxBlocks)
+		nbBlocks = maxBlocks;
+	if (nbBlocks > 1) {
+		run(n, nbBlocks, [](void* function, unsigned int begin, unsigned int end) {
+			(*static_cast<Function*>(function))(begin, end);
+		}, &function);
+		return;
+	}
+#else
+	(void)minBlockSize;
+#endif
+	function(0u, n);
+}
+
+// Same as threadPool->parallelFor, on the calling thread alone when threadPool is nullptr
+template<typename Function>
+void parallelFor(ThreadPool* threadPool, unsigned int n, Function function, unsigned int minBlockSize = PARALLEL_MIN_BLOCK_SIZE) {
+	if (threadPool != nullptr)
+		threadPool->parallelFor(n, function, minBlockSize);
+	else
+		function(0u, n);
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "MemoryResource.h"
+
+// Owns objects carved out of slabs and recycled through a free list, the slabs are kept by clear()
+// and only released with the pool. NextFree is the pointer of T that chains the released objects,
+// it is free for the pool once an object is released.
+template<typename T, T* T::*NextFree>
+class SlabPool
+{
+public:
+	// nullptr takes the slabs from the default resource
+	explicit SlabPool(MemoryResource* resource = nullptr) :
+		mResource(resource != nullptr ? resource : getDefaultMemoryResource()), mSlabs(nullptr), mCurrentSlab(nullptr), mSlabSize(0), mFree(nullptr) {
+
+	}
+
+	~SlabPool() {
+		// Release all the objects at once
+		while (mSlabs != nullptr) {
+			Slab* slab = mSlabs;
+			mSlabs = slab->next;
+			destroyArray(mResource, slab->objects, slab->capacity);
+			destroyArray(mResource, slab, 1);
+		}
+	}
+
+	// Remove copy operations, the pool owns its slabs
+	SlabPool(const SlabPool&) = delete;
+	SlabPool& operator=(const SlabPool&) = delete;
+
+	// Operations
+	void release(T* object) {
+		object->*NextFree = mFree;
+		mFree = object;
+	}
+
+	// Forget all the objects but keep the slabs
+	void clear() {
+		mCurrentSlab = mSlabs;
+		mSlabSize = 0;
+		mFree = nullptr;
+	}
+
+protected:
+	// Storage for one object, it is initialized by the caller
+	T* allocate() {
+		// Recycle a released object first
+		if (mFree != nullptr) {
+			T* object = mFree;
+			mFree = object->*NextFree;
+			return object;
+		}
+		// Otherwise take the next object of the current slab
+		if (mCurrentSlab == nullptr || mSlabSize == mCurrentSlab->capacity) {
+			if (mCurrentSlab != nullptr && mCurrentSlab->next != nullptr) {
+				mCurrentSlab = mCurrentSlab->next;		// Reuse a slab kept by clear()
+			}
+			else {										// Slabs double in size
+				unsigned int capacity = mCurrentSlab == nullptr ? MIN_SLAB_CAPACITY : 2 * mCurrentSlab->capacity;
+				Slab* slab = createArray<Slab>(mResource, 1);
+				*slab = Slab{createArray<T>(mResource, capacity), capacity, nullptr};
+				if (mCurrentSlab == nullptr)
+					mSlabs = slab;
+				else
+					mCurrentSlab->next = slab;
+				mCurrentSlab = slab;
+			}
+			mSlabSize = 0;
+		}
+		return &mCurrentSlab->objects[mSlabSize++];
+	}
+
+private:
+	struct Slab
+	{
+		T* objects;
+		unsigned int capacity;
+		Slab* next;
+	};
+
+	static constexpr unsigned int MIN_SLAB_CAPACITY = 64;
+
+	MemoryResource* mResource;
+	Slab* mSlabs;			// Oldest slab first
+	Slab* mCurrentSlab;		// Slab in which the next object is carved
+	unsigned int mSlabSize;	// Number of objects used in the current slab
+	T* mFree;
+};
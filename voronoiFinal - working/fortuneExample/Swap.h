@@ -0,0 +1,9 @@
+#pragma once
+
+// Swaps a and b by moving them, pools and diagrams exchange their storage without copying it
+template<typename T>
+inline void swapValues(T& a, T& b) {
+	T tmp(static_cast<T&&>(a));
+	a = static_cast<T&&>(b);
+	b = static_cast<T&&>(tmp);
+}
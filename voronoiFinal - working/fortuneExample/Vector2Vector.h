@@ -1,23 +1,26 @@
 #pragma once
+#include "IndexPool.h"
 #include "Vector2.h"
 
+// Points stored by value and contiguously, Vector2 itself carries no links
 struct Vector2Vector {
-	Vector2 *head;
-	Vector2 *tail;
-	unsigned int mSize = 0;
-
-	Vector2Vector();
+	IndexPool<Vector2> mElements;
 
+	// nullptr takes the points from the default resource
+	explicit Vector2Vector(MemoryResource* resource = nullptr);
 
 	// Necessary vector functions
 	bool empty() const;
-	unsigned int size();
-	void push_back(Vector2 *e);
-	void emplace_back(Vector2 *e);
-	Vector2* pop_back();
+	unsigned int size() const;
+	void reserve(unsigned int capacity);
+	void resize(unsigned int size);
+	void push_back(const Vector2& e);
+	void emplace_back(const Vector2& e);
+	Vector2 pop_back();							// The vector must not be empty
 
 	void swap(unsigned int i, unsigned int j);
 
 	// [] Operator
-	Vector2 operator[](unsigned int index);
-};
\ No newline at end of file
+	Vector2& operator[](unsigned int index);
+	const Vector2& operator[](unsigned int index) const;
+};
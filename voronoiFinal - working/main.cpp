@@ -1,12 +1,23 @@
 // STL
 #include <iostream>
 #include <vector>
+#include <algorithm>
+#include <limits>
+#include <cstring>
 #include <chrono>
 #include <random>
+#include <thread>
 // SFML
 #include <SFML/Graphics.hpp>
 // My includes
 #include "FortuneAlgorithm.h"
+#include "LloydRelaxation.h"
+#include "CvtSolver.h"
+#include "ParallelFortuneAlgorithm.h"
+#include "CellClippingAlgorithm.h"
+#include "BatchFortuneAlgorithm.h"
+#include "FixedFortuneAlgorithm.h"
+#include "Shoelace.h"
 #include "Vector2Vector.h"
 
 constexpr float WINDOW_WIDTH = 600.0f;
@@ -22,11 +33,12 @@ Vector2Vector generatePoints(int nbPoints)
     std::uniform_real_distribution<double> distribution (0.0, 1.0);
 
     Vector2Vector points;
+    points.reserve(nbPoints);
 	for (int i = 0; i < nbPoints; ++i) {
 		double x = distribution(generator);
 		double y = distribution(generator);
 		std::cout << "Pushing:\t(" << x << ", " << y << ")" << std::endl;
-		points.push_back(new Vector2{ distribution(generator), distribution(generator) });
+		points.push_back(Vector2(distribution(generator), distribution(generator)));
 	}
     return points;
 }
@@ -49,54 +61,55 @@ void drawEdge(sf::RenderWindow& window, Vector2 origin, Vector2 destination, sf:
     window.draw(line, 2, sf::Lines);
 }
 
-void drawPoints(sf::RenderWindow& window, VoronoiDiagram& diagram)
+void drawPoints(sf::RenderWindow& window, const VoronoiDiagram& diagram)
 {
     for (unsigned int i = 0; i < diagram.getNbSites(); ++i)
         drawPoint(window, diagram.getSite(i)->point, sf::Color(100, 250, 50));
 }
 
-void drawCentroids(sf::RenderWindow& window, Vector2Vector myCentroids)
+void drawCentroids(sf::RenderWindow& window, const Vector2Vector& myCentroids)
 {
 	for (unsigned int i = 0; i < myCentroids.size(); ++i)
 		drawPoint(window, myCentroids[i], sf::Color(255, 0, 250));
 }
 
-void drawDiagram(sf::RenderWindow& window, VoronoiDiagram& diagram)
+void drawDiagram(sf::RenderWindow& window, const VoronoiDiagram& diagram)
 {
     for (unsigned int i = 0; i < diagram.getNbSites(); ++i)
     {
         const VoronoiDiagram::Site* site = diagram.getSite(i);
         Vector2 center = site->point;
-        VoronoiDiagram::Face* face = site->face;
-        VoronoiDiagram::HalfEdge* halfEdge = face->outerComponent;
-        if (halfEdge == nullptr)
+        const VoronoiDiagram::Face* face = diagram.getFace(site->face);
+        unsigned int halfEdge = face->outerComponent;
+        if (halfEdge == VoronoiDiagram::NONE)
             continue;
-        while (halfEdge->prev != nullptr)
+        while (diagram.getHalfEdge(halfEdge)->prev != VoronoiDiagram::NONE)
         {
-            halfEdge = halfEdge->prev;
+            halfEdge = diagram.getHalfEdge(halfEdge)->prev;
             if (halfEdge == face->outerComponent)
                 break;
         }
-        VoronoiDiagram::HalfEdge* start = halfEdge;
-        while (halfEdge != nullptr)
+        unsigned int start = halfEdge;
+        while (halfEdge != VoronoiDiagram::NONE)
         {
-            if (halfEdge->origin != nullptr && halfEdge->destination != nullptr)
+            const VoronoiDiagram::HalfEdge* edge = diagram.getHalfEdge(halfEdge);
+            if (edge->origin != VoronoiDiagram::NONE && edge->destination != VoronoiDiagram::NONE)
             {
-                Vector2 origin = (halfEdge->origin->point - center) * OFFSET + center;
-                Vector2 destination = (halfEdge->destination->point - center) * OFFSET + center;
+                Vector2 origin = (diagram.getVertex(edge->origin)->point - center) * OFFSET + center;
+                Vector2 destination = (diagram.getVertex(edge->destination)->point - center) * OFFSET + center;
                 drawEdge(window, origin, destination, sf::Color::Red);
             }
-            halfEdge = halfEdge->next;
+            halfEdge = edge->next;
             if (halfEdge == start)
                 break;
         }
     }
 }
 
-VoronoiDiagram generateRandomDiagram(unsigned int nbPoints)
+VoronoiDiagram generateRandomDiagram(FortuneAlgorithm& algorithm, unsigned int nbPoints)
 {
-    // Generate points and construct diagram
-	FortuneAlgorithm algorithm(generatePoints(nbPoints));
+    // Generate points and construct diagram, the algorithm reuses its event and beachline storage
+	algorithm.reset(generatePoints(nbPoints));
     auto start = std::chrono::steady_clock::now();
     algorithm.construct();
     auto duration = std::chrono::steady_clock::now() - start;
@@ -107,7 +120,7 @@ VoronoiDiagram generateRandomDiagram(unsigned int nbPoints)
     algorithm.bound(Box{-0.05, -0.05, 1.05, 1.05}); // Take the bounding box slightly bigger than the intersection box
     duration = std::chrono::steady_clock::now() - start;
     std::cout << "bounding: " << std::chrono::duration_cast<std::chrono::milliseconds>(duration).count() << "ms" << '\n';
-    VoronoiDiagram diagram = algorithm.getDiagram();
+    VoronoiDiagram diagram = algorithm.takeDiagram();
 
     // Intersect the diagram with a box
     start = std::chrono::steady_clock::now();
@@ -120,19 +133,576 @@ VoronoiDiagram generateRandomDiagram(unsigned int nbPoints)
     return diagram;
 }
 
-int main()
+// Interleaved coordinates of random points, the same seed gives the same points
+std::vector<double> generateCoordinates(int nbPoints, unsigned int seed)
 {
+    std::default_random_engine generator(seed);
+    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+    std::vector<double> coordinates(2 * nbPoints);
+    for (double& coordinate : coordinates)
+        coordinate = distribution(generator);
+    return coordinates;
+}
+
+// Best construction time out of nbRuns on the same points
+template<typename Algorithm>
+double timeConstruction(Algorithm& algorithm, PointSpan points, int nbRuns)
+{
+    double best = 0.0;
+    for (int i = 0; i < nbRuns; ++i)
+    {
+        algorithm.reset(points);
+        auto start = std::chrono::steady_clock::now();
+        algorithm.construct();
+        std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+        if (i == 0 || duration.count() < best)
+            best = duration.count();
+    }
+    return best;
+}
+
+// Compare the beachlines on random inputs of increasing size and report the fastest for each size
+void benchmarkBeachlines()
+{
+    const char* names[] = {"red-black tree", "flat array", "B-tree"};
+    BasicFortuneAlgorithm<Beachline> redBlackTreeAlgorithm;
+    BasicFortuneAlgorithm<FlatBeachline> flatAlgorithm;
+    BasicFortuneAlgorithm<BTreeBeachline> bTreeAlgorithm;
+    for (int nbPoints = 1000; nbPoints <= 1000000; nbPoints *= 10)
+    {
+        // The points are passed in place as interleaved coordinates
+        std::vector<double> coordinates = generateCoordinates(nbPoints, nbPoints);
+        PointSpan points(coordinates.data(), nbPoints);
+        int nbRuns = nbPoints <= 10000 ? 20 : 3;
+        double durations[] = {
+            timeConstruction(redBlackTreeAlgorithm, points, nbRuns),
+            timeConstruction(flatAlgorithm, points, nbRuns),
+            timeConstruction(bTreeAlgorithm, points, nbRuns)
+        };
+        int winner = 0;
+        std::cout << nbPoints << " points:";
+        for (int i = 0; i < 3; ++i)
+        {
+            std::cout << ' ' << names[i] << ' ' << durations[i] << "ms";
+            if (durations[i] < durations[winner])
+                winner = i;
+        }
+        std::cout << " -> " << names[winner] << '\n';
+    }
+}
+
+// Compare getCentroid, which follows the half edges, with the shoelace kernel on packed vertices
+void benchmarkShoelace()
+{
+    const int nbPoints = 100000;
+    const int nbRuns = 10;
+    std::vector<double> coordinates = generateCoordinates(nbPoints, nbPoints);
+    FortuneAlgorithm algorithm(PointSpan(coordinates.data(), nbPoints));
+    algorithm.construct();
+    algorithm.bound(Box{-0.05, -0.05, 1.05, 1.05});
+    VoronoiDiagram diagram = algorithm.takeDiagram();
+    diagram.intersect(Box{0.0, 0.0, 1.0, 1.0});
+    // The cells have at most as many vertices in all as the diagram has half edges
+    std::vector<unsigned int> offsets(nbPoints + 1, 0);
+    std::vector<double> x(diagram.getHalfEdges().size());
+    std::vector<double> y(diagram.getHalfEdges().size());
+    std::vector<double> centroidX(nbPoints), centroidY(nbPoints), area(nbPoints), perimeter(nbPoints);
+    VoronoiDiagram::CellMeasures measures{centroidX.data(), centroidY.data(), area.data(), perimeter.data(), nullptr};
+
+    // getCentroid and computeCellMeasures walk the half edges of each face, the kernel needs the
+    // faces packed first so the packing is timed too: the kernel alone is only the cost for
+    // polygons already packed
+    double bestWalk = 0.0;
+    double bestMeasures = 0.0;
+    double bestPacking = 0.0;
+    double bestKernel = 0.0;
+    double checksum = 0.0;
+    for (int run = 0; run < nbRuns; ++run)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < nbPoints; ++i)
+            checksum += diagram.getCentroid(i).x;
+        std::chrono::duration<double, std::milli> walk = std::chrono::steady_clock::now() - start;
+        start = std::chrono::steady_clock::now();
+        diagram.computeCellMeasures(measures);
+        checksum += centroidX[run];
+        std::chrono::duration<double, std::milli> cellMeasures = std::chrono::steady_clock::now() - start;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < nbPoints; ++i)
+            offsets[i + 1] = offsets[i] + diagram.copyFaceVertices(i, x.data() + offsets[i], y.data() + offsets[i], static_cast<unsigned int>(x.size()) - offsets[i]);
+        std::chrono::duration<double, std::milli> packing = std::chrono::steady_clock::now() - start;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < nbPoints; ++i)
+        {
+            PolygonMeasures polygon = computePolygonMeasures(&x[offsets[i]], &y[offsets[i]], offsets[i + 1] - offsets[i]);
+            checksum -= polygon.momentX / (3.0 * polygon.doubleArea);
+        }
+        std::chrono::duration<double, std::milli> kernel = std::chrono::steady_clock::now() - start;
+        if (run == 0 || walk.count() < bestWalk)
+            bestWalk = walk.count();
+        if (run == 0 || cellMeasures.count() < bestMeasures)
+            bestMeasures = cellMeasures.count();
+        if (run == 0 || packing.count() < bestPacking)
+            bestPacking = packing.count();
+        if (run == 0 || kernel.count() < bestKernel)
+            bestKernel = kernel.count();
+    }
+    std::cout << nbPoints << " faces: getCentroid " << bestWalk << "ms, computeCellMeasures on 1 thread "
+        << bestMeasures << "ms, packing " << bestPacking << "ms + "
+        << getShoelaceKernelName() << " kernel " << bestKernel << "ms = " << bestPacking + bestKernel
+        << "ms (checksum " << checksum << ")\n";
+}
+
+// Number of diagram constructions needed by L-BFGS to reach the energy of a long Lloyd relaxation
+void benchmarkRelaxation()
+{
+    const unsigned int nbPoints = 10000;
+    const unsigned int nbLloydSteps = 200;
+    std::vector<double> coordinates = generateCoordinates(nbPoints, 0);
+    PointSpan points(coordinates.data(), nbPoints);
+
+    auto start = std::chrono::steady_clock::now();
+    LloydRelaxation relaxation(Box{0.0, 0.0, 1.0, 1.0});
+    relaxation.reset(points);
+    for (unsigned int i = 0; i < nbLloydSteps; ++i)
+        relaxation.step();
+    std::chrono::duration<double, std::milli> lloydDuration = std::chrono::steady_clock::now() - start;
+    double energy = relaxation.getEnergy();
+
+    start = std::chrono::steady_clock::now();
+    CvtSolver solver(Box{0.0, 0.0, 1.0, 1.0});
+    solver.reset(points);
+    while (solver.step())
+    {
+        if (solver.getEnergy() <= energy || solver.getNbConstructions() >= nbLloydSteps)
+            break;
+    }
+    std::chrono::duration<double, std::milli> solverDuration = std::chrono::steady_clock::now() - start;
+
+    std::cout << nbPoints << " sites: Lloyd " << nbLloydSteps << " constructions " << lloydDuration.count()
+        << "ms (energy " << energy << "), L-BFGS " << solver.getNbConstructions() << " constructions "
+        << solverDuration.count() << "ms (energy " << solver.getEnergy() << ")\n";
+}
+
+// Speedup of the construction over strips with the number of threads, compared to a single sweep
+void benchmarkParallelConstruction()
+{
+    unsigned int nbHardwareThreads = std::thread::hardware_concurrency();
+    FortuneAlgorithm serialAlgorithm;
+    for (int nbPoints = 100000; nbPoints <= 10000000; nbPoints *= 10)
+    {
+        std::vector<double> coordinates = generateCoordinates(nbPoints, nbPoints);
+        PointSpan points(coordinates.data(), nbPoints);
+        double serialDuration = timeConstruction(serialAlgorithm, points, 3);
+        std::cout << nbPoints << " points: single sweep " << serialDuration << "ms";
+        for (unsigned int nbThreads = 2; nbThreads <= nbHardwareThreads; nbThreads *= 2)
+        {
+            ParallelFortuneAlgorithm parallelAlgorithm(nbThreads);
+            double duration = timeConstruction(parallelAlgorithm, points, 3);
+            std::cout << ", " << parallelAlgorithm.getNbStrips() << " strips " << duration << "ms (x"
+                << serialDuration / duration << ")";
+        }
+        std::cout << '\n';
+    }
+}
+
+// Clipped diagram built cell by cell against a sweep followed by the clipping on the box, then
+// single cells computed from the k-d tree against whole diagrams
+void benchmarkCellClipping()
+{
+    const Box box{0.0, 0.0, 1.0, 1.0};
+    const int nbRuns = 3;
+    unsigned int nbHardwareThreads = std::thread::hardware_concurrency();
+    FortuneAlgorithm sweepAlgorithm;
+    for (int nbPoints = 100000; nbPoints <= 1000000; nbPoints *= 10)
+    {
+        std::vector<double> coordinates = generateCoordinates(nbPoints, nbPoints);
+        PointSpan points(coordinates.data(), nbPoints);
+        double sweepDuration = 0.0;
+        for (int i = 0; i < nbRuns; ++i)
+        {
+            sweepAlgorithm.reset(points);
+            auto start = std::chrono::steady_clock::now();
+            sweepAlgorithm.construct();
+            sweepAlgorithm.bound(Box{-0.05, -0.05, 1.05, 1.05});
+            VoronoiDiagram diagram = sweepAlgorithm.takeDiagram();
+            diagram.intersect(box);
+            std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+            sweepAlgorithm.recycleDiagram(std::move(diagram));
+            if (i == 0 || duration.count() < sweepDuration)
+                sweepDuration = duration.count();
+        }
+        std::cout << nbPoints << " points: sweep and intersection " << sweepDuration << "ms";
+        for (unsigned int nbThreads = 1; nbThreads <= nbHardwareThreads; nbThreads *= 2)
+        {
+            // The k-d tree is built by reset, it is part of the construction
+            CellClippingAlgorithm clippingAlgorithm(box, nbThreads);
+            double duration = 0.0;
+            for (int i = 0; i < nbRuns; ++i)
+            {
+                auto start = std::chrono::steady_clock::now();
+                clippingAlgorithm.reset(points);
+                clippingAlgorithm.construct();
+                std::chrono::duration<double, std::milli> runDuration = std::chrono::steady_clock::now() - start;
+                if (i == 0 || runDuration.count() < duration)
+                    duration = runDuration.count();
+            }
+            std::cout << ", cells on " << nbThreads << " threads " << duration << "ms (x" << sweepDuration / duration << ")";
+        }
+        std::cout << '\n';
+
+        // Single cells of random sites, the tree is already built
+        const int nbQueries = 100000;
+        CellClippingAlgorithm clippingAlgorithm(box);
+        clippingAlgorithm.reset(points);
+        ClippedCell cell;
+        std::default_random_engine generator(0);
+        std::uniform_int_distribution<int> distribution(0, nbPoints - 1);
+        unsigned int nbVertices = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < nbQueries; ++i)
+        {
+            clippingAlgorithm.computeCell(distribution(generator), cell);
+            nbVertices += cell.getNbVertices();
+        }
+        std::chrono::duration<double, std::micro> duration = std::chrono::steady_clock::now() - start;
+        std::cout << "  single cell " << duration.count() / nbQueries << "us (" << static_cast<double>(nbVertices) / nbQueries
+            << " vertices on average)\n";
+    }
+}
+
+// Diagrams per second per core for many small diagrams, built one by one with a new algorithm
+// each time as generateRandomDiagram does, then by batches
+void benchmarkBatchConstruction()
+{
+    const Box box{0.0, 0.0, 1.0, 1.0};
+    const int nbDiagrams = 100000;
+    unsigned int nbHardwareThreads = std::thread::hardware_concurrency();
+    for (int nbSites : {11, 32})
+    {
+        std::vector<double> coordinates = generateCoordinates(nbDiagrams * nbSites, nbSites);
+        std::vector<unsigned int> offsets(nbDiagrams + 1);
+        for (int i = 0; i <= nbDiagrams; ++i)
+            offsets[i] = i * nbSites;
+        PointSpan points(coordinates.data(), nbDiagrams * nbSites);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < nbDiagrams; ++i)
+        {
+            FortuneAlgorithm algorithm(points.getSubspan(offsets[i], nbSites));
+            algorithm.construct();
+            algorithm.bound(Box{-0.05, -0.05, 1.05, 1.05});
+            VoronoiDiagram diagram = algorithm.takeDiagram();
+            diagram.intersect(box);
+        }
+        std::chrono::duration<double> oneByOneDuration = std::chrono::steady_clock::now() - start;
+        std::cout << nbDiagrams << " diagrams of " << nbSites << " sites: one by one "
+            << nbDiagrams / oneByOneDuration.count() << " diagrams/s";
+        for (unsigned int nbThreads = 1; nbThreads <= nbHardwareThreads; nbThreads *= 2)
+        {
+            BatchFortuneAlgorithm batchAlgorithm(box, nbThreads);
+            // The first batch sizes the storage of the workers
+            batchAlgorithm.construct(points, offsets.data(), nbDiagrams);
+            start = std::chrono::steady_clock::now();
+            batchAlgorithm.construct(points, offsets.data(), nbDiagrams);
+            std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+            double throughput = nbDiagrams / duration.count();
+            std::cout << ", batch on " << nbThreads << " threads " << throughput << " diagrams/s ("
+                << throughput / nbThreads << " per core)";
+        }
+        std::cout << '\n';
+    }
+}
+
+// Latency of one diagram of N sites clipped to the box, built by a reused FortuneAlgorithm and by
+// FixedFortuneAlgorithm<N>
+template<unsigned int N>
+void benchmarkFixedConstruction()
+{
+    const Box box{0.0, 0.0, 1.0, 1.0};
+    const int nbDiagrams = (1 << 20) / N;
+    std::vector<double> coordinates = generateCoordinates(nbDiagrams * N, N);
+    PointSpan points(coordinates.data(), nbDiagrams * N);
+
+    FortuneAlgorithm algorithm;
+    VoronoiDiagram diagram;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < nbDiagrams; ++i)
+    {
+        algorithm.recycleDiagram(std::move(diagram));
+        algorithm.reset(points.getSubspan(i * N, N));
+        algorithm.construct();
+        algorithm.bound(Box{-0.05, -0.05, 1.05, 1.05});
+        diagram = algorithm.takeDiagram();
+        diagram.intersect(box);
+    }
+    std::chrono::duration<double, std::micro> dynamicDuration = std::chrono::steady_clock::now() - start;
+
+    static FixedFortuneAlgorithm<N> fixedAlgorithm(box);
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < nbDiagrams; ++i)
+        fixedAlgorithm.construct(points.getSubspan(i * N, N));
+    std::chrono::duration<double, std::micro> fixedDuration = std::chrono::steady_clock::now() - start;
+    std::cout << N << " sites: dynamic " << dynamicDuration.count() / nbDiagrams << " us, fixed "
+        << fixedDuration.count() / nbDiagrams << " us (x" << dynamicDuration.count() / fixedDuration.count() << ")\n";
+}
+
+// Construction from a monotonic buffer: the first diagram takes the storage of the builder from
+// the buffer, the next ones of the same size must not take anything more
+void benchmarkMemoryResource()
+{
+    const int nbPoints = 10000;
+    const int nbRuns = 100;
+    std::vector<double> coordinates = generateCoordinates(nbPoints, nbPoints);
+    PointSpan points(coordinates.data(), nbPoints);
+    std::vector<unsigned char> buffer(64 << 20);
+    MonotonicBufferResource resource(buffer.data(), buffer.size());
+
+    auto buildDiagrams = [points](FortuneAlgorithm& algorithm, int nbDiagrams)
+    {
+        for (int i = 0; i < nbDiagrams; ++i)
+        {
+            algorithm.reset(points);
+            algorithm.construct();
+            algorithm.bound(Box{-0.05, -0.05, 1.05, 1.05});
+            VoronoiDiagram diagram = algorithm.takeDiagram();
+            diagram.intersect(Box{0.0, 0.0, 1.0, 1.0});
+            algorithm.recycleDiagram(std::move(diagram));
+        }
+    };
+    FortuneAlgorithm arenaAlgorithm(&resource);
+    buildDiagrams(arenaAlgorithm, 1);
+    std::size_t warmUpSize = resource.getUsedSize();
+    auto start = std::chrono::steady_clock::now();
+    buildDiagrams(arenaAlgorithm, nbRuns);
+    std::chrono::duration<double, std::milli> arenaDuration = std::chrono::steady_clock::now() - start;
+
+    FortuneAlgorithm defaultAlgorithm;
+    buildDiagrams(defaultAlgorithm, 1);
+    start = std::chrono::steady_clock::now();
+    buildDiagrams(defaultAlgorithm, nbRuns);
+    std::chrono::duration<double, std::milli> defaultDuration = std::chrono::steady_clock::now() - start;
+    std::cout << nbPoints << " points: " << warmUpSize << " bytes after warm-up, "
+        << resource.getUsedSize() - warmUpSize << " bytes taken by " << nbRuns << " more diagrams, "
+        << arenaDuration.count() / nbRuns << "ms from the buffer, "
+        << defaultDuration.count() / nbRuns << "ms from operator new" << std::endl;
+}
+
+// Largest distance from a vertex of a cell to the nearest vertex of the other cell, both ways so
+// that the duplicated vertices of degenerate inputs do not count
+double getCellDistance(const std::vector<Vector2>& vertices, const std::vector<Vector2>& otherVertices)
+{
+    if (vertices.empty() || otherVertices.empty())
+        return vertices.size() == otherVertices.size() ? 0.0 : std::numeric_limits<double>::infinity();
+    auto getDistance = [](const std::vector<Vector2>& from, const std::vector<Vector2>& to)
+    {
+        double maxDistance = 0.0;
+        for (const Vector2& vertex : from)
+        {
+            double distance = std::numeric_limits<double>::infinity();
+            for (const Vector2& otherVertex : to)
+                distance = std::min(distance, vertex.getDistance(otherVertex));
+            maxDistance = std::max(maxDistance, distance);
+        }
+        return maxDistance;
+    };
+    return std::max(getDistance(vertices, otherVertices), getDistance(otherVertices, vertices));
+}
+
+// Distance between the cells of a site in two diagrams
+double getCellDistance(const VoronoiDiagram& diagram, const VoronoiDiagram& otherDiagram, unsigned int site)
+{
+    std::vector<Vector2> vertices;
+    std::vector<Vector2> otherVertices;
+    for (const Vector2& vertex : diagram.getFaceVertices(site))
+        vertices.push_back(vertex);
+    for (const Vector2& vertex : otherDiagram.getFaceVertices(site))
+        otherVertices.push_back(vertex);
+    return getCellDistance(vertices, otherVertices);
+}
+
+// Compare the cells of the parallel sweep and of the cell clipping with the ones of a single sweep
+// clipped on the same box, on random sites, on a grid, on a partial grid whose vertices fall exactly
+// on the box, on a row and on a column, and report how often they fell back to a single sweep.
+// Returns the number of cells that differ
+unsigned int checkConstructions()
+{
+    const Box box{0.0, 0.0, 1.0, 1.0};
+    const double tolerance = 1e-9;
+    const unsigned int nbThreads = 4;
+    const int nbPoints = 20000;
+    const int gridSize = 141;
+    const int nbSeeds = 5;
+    const char* names[] = {"grid", "partial grid", "row", "column"};
+    const int nbInputs = nbSeeds + 4;
+    FortuneAlgorithm serialAlgorithm;
+    ParallelFortuneAlgorithm parallelAlgorithm(nbThreads);
+    CellClippingAlgorithm clippingAlgorithm(box, nbThreads);
+    VoronoiDiagram reference;
+    unsigned int nbErrors = 0;
+    int nbParallelFallbacks = 0;
+    int nbClippingFallbacks = 0;
+    for (int input = 0; input < nbInputs; ++input)
+    {
+        std::vector<double> coordinates;
+        if (input < nbSeeds)
+            coordinates = generateCoordinates(nbPoints, input);
+        else if (input < nbSeeds + 2)
+        {
+            // 19 sites on a grid of width 8 have a vertex at (0.75, 1), on the top of the box
+            int width = input == nbSeeds ? gridSize : 8;
+            int nbSites = input == nbSeeds ? gridSize * gridSize : 19;
+            for (int i = 0; i < nbSites; ++i)
+            {
+                coordinates.push_back((i % width + 0.5) / width);
+                coordinates.push_back((i / width + 0.5) / width);
+            }
+        }
+        else
+        {
+            for (int i = 0; i < nbPoints; ++i)
+            {
+                double x = (i + 0.5) / nbPoints;
+                coordinates.push_back(input == nbSeeds + 3 ? 0.5 : x);
+                coordinates.push_back(input == nbSeeds + 3 ? x : 0.5);
+            }
+        }
+        PointSpan points(coordinates.data(), coordinates.size() / 2);
+        serialAlgorithm.reset(points);
+        bool isReferenceValid = serialAlgorithm.constructClipped(box, reference);
+
+        parallelAlgorithm.reset(points);
+        parallelAlgorithm.construct();
+        parallelAlgorithm.bound(Box{-0.05, -0.05, 1.05, 1.05});
+        VoronoiDiagram parallelDiagram = parallelAlgorithm.takeDiagram();
+        bool isParallelValid = parallelDiagram.intersect(box);
+        bool isParallelFallback = parallelAlgorithm.getNbStrips() == 1;
+
+        clippingAlgorithm.reset(points);
+        bool isClippingValid = clippingAlgorithm.construct();
+        const VoronoiDiagram& clippingDiagram = clippingAlgorithm.getDiagram();
+
+        unsigned int nbParallelErrors = isParallelValid == isReferenceValid ? 0 : 1;
+        unsigned int nbClippingErrors = isClippingValid == isReferenceValid ? 0 : 1;
+        for (unsigned int i = 0; i < points.size() && isReferenceValid; ++i)
+        {
+            if (isParallelValid && getCellDistance(parallelDiagram, reference, i) > tolerance)
+                ++nbParallelErrors;
+            if (isClippingValid && getCellDistance(clippingDiagram, reference, i) > tolerance)
+                ++nbClippingErrors;
+        }
+        if (input < nbSeeds)
+            std::cout << "random seed " << input;
+        else
+            std::cout << names[input - nbSeeds];
+        std::cout << ", " << points.size() << " sites: parallel " << nbParallelErrors << " different cells"
+            << (isParallelFallback ? " (single sweep)" : "") << ", cell clipping " << nbClippingErrors
+            << " different cells" << (clippingAlgorithm.usedSweep() ? " (single sweep)" : "") << '\n';
+        nbErrors += nbParallelErrors + nbClippingErrors;
+        nbParallelFallbacks += isParallelFallback ? 1 : 0;
+        nbClippingFallbacks += clippingAlgorithm.usedSweep() ? 1 : 0;
+    }
+    std::cout << "single sweep fallbacks out of " << nbInputs << " inputs: parallel " << nbParallelFallbacks
+        << ", cell clipping " << nbClippingFallbacks << std::endl;
+    return nbErrors;
+}
+
+// Compare the cells of a batch with the ones of a single sweep clipped on the same box, on random
+// diagrams among which some are the partial grid whose vertices fall exactly on the box. Returns
+// the number of diagrams that differ
+unsigned int checkBatchConstruction()
+{
+    const Box box{0.0, 0.0, 1.0, 1.0};
+    const double tolerance = 1e-9;
+    const unsigned int nbThreads = 4;
+    const int nbDiagrams = 256;
+    const int nbSites = 32;
+    std::vector<double> randomCoordinates = generateCoordinates(nbDiagrams * nbSites, 0);
+    std::vector<double> coordinates;
+    std::vector<unsigned int> offsets(1, 0);
+    for (int i = 0; i < nbDiagrams; ++i)
+    {
+        // One diagram out of 64 is the partial grid
+        if (i % 64 == 0)
+        {
+            for (int j = 0; j < 19; ++j)
+            {
+                coordinates.push_back((j % 8 + 0.5) / 8);
+                coordinates.push_back((j / 8 + 0.5) / 8);
+            }
+        }
+        else
+        {
+            auto first = randomCoordinates.begin() + 2 * i * nbSites;
+            coordinates.insert(coordinates.end(), first, first + 2 * nbSites);
+        }
+        offsets.push_back(coordinates.size() / 2);
+    }
+    PointSpan points(coordinates.data(), offsets.back());
+    BatchFortuneAlgorithm batchAlgorithm(box, nbThreads);
+    unsigned int nbInvalidDiagrams = batchAlgorithm.construct(points, offsets.data(), nbDiagrams);
+
+    FortuneAlgorithm serialAlgorithm;
+    VoronoiDiagram reference;
+    unsigned int nbErrors = 0;
+    unsigned int nbInvalidReferences = 0;
+    for (int i = 0; i < nbDiagrams; ++i)
+    {
+        unsigned int nbDiagramSites = offsets[i + 1] - offsets[i];
+        serialAlgorithm.reset(points.getSubspan(offsets[i], nbDiagramSites));
+        bool isReferenceValid = serialAlgorithm.constructClipped(box, reference);
+        nbInvalidReferences += isReferenceValid ? 0 : 1;
+        bool isDifferent = batchAlgorithm.isValid(i) != isReferenceValid;
+        for (unsigned int j = 0; j < nbDiagramSites && isReferenceValid && !isDifferent; ++j)
+        {
+            std::vector<Vector2> vertices;
+            std::vector<Vector2> otherVertices;
+            unsigned int site = offsets[i] + j;
+            for (unsigned int k = 0; k < batchAlgorithm.getNbCellVertices(site); ++k)
+                vertices.push_back(Vector2(batchAlgorithm.getCellX(site)[k], batchAlgorithm.getCellY(site)[k]));
+            for (const Vector2& vertex : reference.getFaceVertices(j))
+                otherVertices.push_back(vertex);
+            isDifferent = getCellDistance(vertices, otherVertices) > tolerance;
+        }
+        nbErrors += isDifferent ? 1 : 0;
+    }
+    std::cout << "batch, " << nbDiagrams << " diagrams: " << nbErrors << " different diagrams, "
+        << nbInvalidDiagrams << " not clipped (" << nbInvalidReferences << " by a single sweep)" << std::endl;
+    return nbErrors;
+}
+
+// Start a relaxation from the sites of the diagram
+void startRelaxation(LloydRelaxation& relaxation, const VoronoiDiagram& diagram)
+{
+    std::vector<double> coordinates(2 * diagram.getNbSites());
+    for (unsigned int i = 0; i < diagram.getNbSites(); ++i)
+    {
+        coordinates[2 * i] = diagram.getSite(i)->point.x;
+        coordinates[2 * i + 1] = diagram.getSite(i)->point.y;
+    }
+    relaxation.reset(PointSpan(coordinates.data(), diagram.getNbSites()));
+}
+
+int main(int argc, char* argv[])
+{
+    // --check compares the builders on the console without opening a window
+    if (argc > 1 && std::strcmp(argv[1], "--check") == 0)
+        return checkConstructions() + checkBatchConstruction() == 0 ? 0 : 1;
+
     unsigned int nbPoints = 11;
-    VoronoiDiagram diagram = generateRandomDiagram(nbPoints);
+    FortuneAlgorithm algorithm;
+    VoronoiDiagram diagram = generateRandomDiagram(algorithm, nbPoints);
 	Vector2Vector c = diagram.getCentroids();
 	std::cout << "\n\nAll vertices:\n" << std::endl;
-	VoronoiDiagram::VertexList myVertices = diagram.getVertices();
-	VoronoiDiagram::Vertex* tmp = myVertices.head;
-	while (tmp->listNext != nullptr) {
-		std::cout << "(" << tmp->point.x << ", " << tmp->point.y << ")" << std::endl;
-		tmp = tmp->listNext;
+	const IndexPool<VoronoiDiagram::Vertex>& myVertices = diagram.getVertices();
+	for (unsigned int i = 0; i < myVertices.size(); ++i) {
+		std::cout << "(" << myVertices[i].point.x << ", " << myVertices[i].point.y << ")" << std::endl;
 	}
 
+    // Diagram on screen, L relaxes it one step at a time and N goes back to a random one
+    LloydRelaxation relaxation(Box{0.0, 0.0, 1.0, 1.0});
+    const VoronoiDiagram* shownDiagram = &diagram;
+
     // Display the diagram
     sf::ContextSettings settings;
     settings.antialiasingLevel = 8;
@@ -147,13 +717,52 @@ int main()
             if (event.type == sf::Event::Closed)
                 window.close();
             else if (event.type == sf::Event::KeyReleased && event.key.code == sf::Keyboard::Key::N)
-                diagram = generateRandomDiagram(nbPoints);
+            {
+                diagram = generateRandomDiagram(algorithm, nbPoints);
+                shownDiagram = &diagram;
+                c = diagram.getCentroids();
+            }
+            else if (event.type == sf::Event::KeyReleased && event.key.code == sf::Keyboard::Key::L)
+            {
+                if (shownDiagram == &diagram)
+                    startRelaxation(relaxation, diagram);
+                if (relaxation.step())
+                {
+                    shownDiagram = &relaxation.getDiagram();
+                    c = shownDiagram->getCentroids();
+                    std::cout << "Lloyd step: energy " << relaxation.getEnergy()
+                        << ", max displacement " << relaxation.getMaxDisplacement() << std::endl;
+                }
+            }
+            else if (event.type == sf::Event::KeyReleased && event.key.code == sf::Keyboard::Key::B)
+                benchmarkBeachlines();
+            else if (event.type == sf::Event::KeyReleased && event.key.code == sf::Keyboard::Key::C)
+                benchmarkShoelace();
+            else if (event.type == sf::Event::KeyReleased && event.key.code == sf::Keyboard::Key::R)
+                benchmarkRelaxation();
+            else if (event.type == sf::Event::KeyReleased && event.key.code == sf::Keyboard::Key::P)
+                benchmarkParallelConstruction();
+            else if (event.type == sf::Event::KeyReleased && event.key.code == sf::Keyboard::Key::K)
+                benchmarkCellClipping();
+            else if (event.type == sf::Event::KeyReleased && event.key.code == sf::Keyboard::Key::T)
+                benchmarkBatchConstruction();
+            else if (event.type == sf::Event::KeyReleased && event.key.code == sf::Keyboard::Key::F)
+            {
+                benchmarkFixedConstruction<8>();
+                benchmarkFixedConstruction<16>();
+                benchmarkFixedConstruction<32>();
+                benchmarkFixedConstruction<64>();
+                benchmarkFixedConstruction<128>();
+                benchmarkFixedConstruction<256>();
+            }
+            else if (event.type == sf::Event::KeyReleased && event.key.code == sf::Keyboard::Key::M)
+                benchmarkMemoryResource();
         }
 
         window.clear(sf::Color::Black);
 
-        drawDiagram(window, diagram);
-        drawPoints(window, diagram);
+        drawDiagram(window, *shownDiagram);
+        drawPoints(window, *shownDiagram);
 		drawCentroids(window, c);
 
         window.display();